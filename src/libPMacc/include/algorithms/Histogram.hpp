@@ -0,0 +1,276 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "nvidia/atomic.hpp"
+
+#include <vector>
+#ifdef _OPENMP
+#   include <omp.h>
+#endif
+
+namespace PMacc
+{
+namespace algorithms
+{
+namespace histogram
+{
+
+    /** add a value to a memory location
+     *
+     * On the device the operation is atomic. On the host every memory
+     * location must be owned by one thread, @see PrivatizedHistogram.
+     */
+    struct AtomicAdd
+    {
+        template<typename T_Type>
+        HDINLINE void operator()(T_Type* ptr, T_Type const value) const
+        {
+#ifdef __CUDA_ARCH__
+            atomicAddWrapper(ptr, value);
+#else
+            *ptr += value;
+#endif
+        }
+    };
+
+    /** per worker cache of the last used bin
+     *
+     * Consecutive values of the same bin are summed in registers and written
+     * with one operation if the bin changes or flush() is called. If all
+     * values of a worker fall into a few bins (e.g. a cold beam) the number
+     * of atomic operations is reduced from one per value to one per run.
+     *
+     * @tparam T_Type type of the bin values
+     */
+    template<typename T_Type>
+    struct BinCache
+    {
+        int bin;
+        T_Type value;
+
+        HDINLINE BinCache() : bin(-1), value(T_Type(0))
+        {
+        }
+
+        /** add a value to a bin
+         *
+         * @param newBin index of the bin, must be >= 0
+         * @param newValue value added to the bin
+         * @param sink functor with the signature `void(int bin, T_Type value)`
+         *             receiving the summed value of the previous bin
+         */
+        PMACC_NO_NVCC_HDWARNING
+        template<typename T_Sink>
+        HDINLINE void add(int const newBin, T_Type const newValue, T_Sink const & sink)
+        {
+            if (newBin != bin)
+            {
+                flush(sink);
+                bin = newBin;
+            }
+            value += newValue;
+        }
+
+        /** write the cached value to the sink and reset the cache */
+        PMACC_NO_NVCC_HDWARNING
+        template<typename T_Sink>
+        HDINLINE void flush(T_Sink const & sink)
+        {
+            if (bin >= 0)
+                sink(bin, value);
+            bin = -1;
+            value = T_Type(0);
+        }
+    };
+
+    /** histogram with private copies for groups of workers
+     *
+     * `numCopies` sub-histograms are stored in one memory block, a worker adds
+     * only to its own copy which reduces the contention of atomic operations
+     * on the same bin. The copies are merged with merge(), one value per bin
+     * is written to the destination.
+     * The memory is not owned, on the device it is usually shared memory
+     * with the size getSize().
+     *
+     * @tparam T_Type type of the bin values
+     * @tparam T_Atomic functor to add a value to a bin of a copy
+     */
+    template<typename T_Type, typename T_Atomic = AtomicAdd>
+    class PrivatizedHistogram
+    {
+    public:
+
+        /** functor adding values to one copy, usable as sink of a BinCache */
+        struct Copy
+        {
+            T_Type* ptr;
+
+            HDINLINE void operator()(int const bin, T_Type const value) const
+            {
+                T_Atomic()(ptr + bin, value);
+            }
+        };
+
+        /** number of elements needed for a histogram
+         *
+         * @param numBins number of bins
+         * @param numCopies number of private copies
+         */
+        HDINLINE static int getSize(int const numBins, int const numCopies)
+        {
+            return getPitch(numBins, numCopies) * numCopies;
+        }
+
+        /** constructor
+         *
+         * @param memory pointer to at least getSize() elements
+         * @param numBins number of bins
+         * @param numCopies number of private copies, must be >= 1
+         */
+        HDINLINE PrivatizedHistogram(T_Type* memory, int const numBins, int const numCopies) :
+            memory(memory), numBins(numBins), numCopies(numCopies), pitch(getPitch(numBins, numCopies))
+        {
+        }
+
+        /** set all bins of all copies to zero, the work is split between all workers
+         *
+         * On the device a barrier is needed before the first add().
+         *
+         * @param worker index of the calling worker, range [0;numWorkers)
+         * @param numWorkers number of workers calling this method
+         */
+        HDINLINE void init(int const worker, int const numWorkers)
+        {
+            const int size = pitch * numCopies;
+            for (int i = worker; i < size; i += numWorkers)
+                memory[i] = T_Type(0);
+        }
+
+        /** get the copy used by a worker
+         *
+         * Neighboring workers use different copies, on the device this
+         * spreads the lanes of a warp over all copies.
+         */
+        HDINLINE Copy getCopy(int const worker) const
+        {
+            Copy copy = {memory + (worker % numCopies) * pitch};
+            return copy;
+        }
+
+        /** add the sum over all copies of each bin to a sink
+         *
+         * On the device a barrier is needed after the last add().
+         *
+         * @param worker index of the calling worker, range [0;numWorkers)
+         * @param numWorkers number of workers calling this method
+         * @param sink functor with the signature `void(int bin, T_Type value)`,
+         *             called once per bin
+         */
+        PMACC_NO_NVCC_HDWARNING
+        template<typename T_Sink>
+        HDINLINE void merge(int const worker, int const numWorkers, T_Sink const & sink) const
+        {
+            for (int bin = worker; bin < numBins; bin += numWorkers)
+            {
+                T_Type sum = memory[bin];
+                for (int c = 1; c < numCopies; ++c)
+                    sum += memory[c * pitch + bin];
+                sink(bin, sum);
+            }
+        }
+
+    private:
+
+        /* copies are padded by one element, the same bin of different
+         * copies is therefore located in different shared memory banks
+         */
+        HDINLINE static int getPitch(int const numBins, int const numCopies)
+        {
+            return numCopies > 1 ? numBins + 1 : numBins;
+        }
+
+        T_Type* memory;
+        int numBins;
+        int numCopies;
+        int pitch;
+    };
+
+    /** fill a histogram on the host
+     *
+     * The items are split between the OpenMP threads (serial without
+     * OpenMP), each thread adds to a private copy with a BinCache.
+     *
+     * @param result pointer to numBins values, the histogram is added to them
+     * @param numBins number of bins
+     * @param numItems number of items
+     * @param binValue functor with the signature `bool(size_t item, int& bin, T_Type& value)`,
+     *                 returns false if the item is not binned
+     */
+    template<typename T_Type, typename T_BinValue>
+    HINLINE void fillHost(T_Type* result, int const numBins, size_t const numItems, T_BinValue const & binValue)
+    {
+#ifdef _OPENMP
+        const int numThreads = omp_get_max_threads();
+#else
+        const int numThreads = 1;
+#endif
+        std::vector<T_Type> memory(PrivatizedHistogram<T_Type>::getSize(numBins, numThreads));
+        PrivatizedHistogram<T_Type> histogram(&memory[0], numBins, numThreads);
+        histogram.init(0, 1);
+
+#ifdef _OPENMP
+#   pragma omp parallel num_threads(numThreads)
+#endif
+        {
+#ifdef _OPENMP
+            const int thread = omp_get_thread_num();
+#else
+            const int thread = 0;
+#endif
+            typename PrivatizedHistogram<T_Type>::Copy const copy = histogram.getCopy(thread);
+            BinCache<T_Type> cache;
+            /* the team can be smaller than numThreads, the work sharing
+             * splits the items between the threads actually started */
+#ifdef _OPENMP
+#   pragma omp for schedule(static)
+#endif
+            for (size_t i = 0; i < numItems; ++i)
+            {
+                int bin = 0;
+                T_Type value = T_Type(0);
+                if (binValue(i, bin, value))
+                    cache.add(bin, value, copy);
+            }
+            cache.flush(copy);
+        }
+
+        histogram.merge(0, 1, [result](int const bin, T_Type const value)
+        {
+            result[bin] += value;
+        });
+    }
+
+} // namespace histogram
+} // namespace algorithms
+} // namespace PMacc
@@ -81,6 +81,8 @@ public:
     CommunicatorMPI() : hostRank(0)
     {
         //MPI_Init(nullptr, nullptr);
+        for (uint32_t i = 0; i < 27; ++i)
+            sentBytes[i] = 0;
     }
 
     /*! dtor
@@ -186,11 +188,23 @@ public:
         return this->coordinates;
     }
 
+    /*! returns the number of bytes sent to the neighbor in direction ex
+     *
+     * The counter is accumulated over all sends since the start of the simulation.
+     *
+     * @param ex exchange type of the neighbor
+     */
+    uint64_t getSentBytes(uint32_t ex) const
+    {
+        return sentBytes[ex];
+    }
+
     // description in ICommunicator
 
     MPI_Request* startSend(uint32_t ex, const char *send_data, size_t send_data_count, uint32_t tag)
     {
         MPI_Request *request = new MPI_Request;
+        sentBytes[ex] += send_data_count;
 
         MPI_CHECK(MPI_Isend(
                             (void*) send_data,
@@ -439,6 +453,8 @@ private:
 
     int mpiRank;
     int mpiSize;
+    //! bytes sent per exchange type \see getSentBytes
+    uint64_t sentBytes[27];
 };
 
 } //namespace PMacc
@@ -0,0 +1,292 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "ppFunctions.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <algorithm>
+#include <stdint.h>
+
+namespace PMacc
+{
+
+/** rank local recorder for timed regions
+ *
+ * Regions are stored in a ring buffer with a fixed number of entries,
+ * if the buffer is full the oldest regions are overwritten.
+ * The recorder is disabled (no memory, one branch per region) until
+ * init() is called with a capacity greater than zero.
+ *
+ * All timestamps are taken on the host: asynchronous operations e.g. kernel
+ * launches are measured from the start of the call until the call returns,
+ * compile with `PMACC_SYNC_KERNEL=1` to include the kernel run time.
+ *
+ * Regions can be added from background threads, the enabled state must only
+ * be changed by init() before these threads are started.
+ */
+class Tracer
+{
+public:
+
+    /** one timed region */
+    struct Region
+    {
+        /** name of the region, must be a string literal or created with intern() */
+        char const * name;
+        /** category of the region, must be a string literal */
+        char const * category;
+        /** start time in nanoseconds */
+        uint64_t begin;
+        /** end time in nanoseconds */
+        uint64_t end;
+        /** simulation step during the region */
+        uint32_t step;
+    };
+
+    static Tracer& getInstance()
+    {
+        static Tracer instance;
+        return instance;
+    }
+
+    /** enable the recorder
+     *
+     * @param capacity maximum number of stored regions, zero disables the recorder
+     */
+    void init(size_t const capacity)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        regions.clear();
+        regions.resize(capacity);
+        numRegions = 0;
+        origin = now();
+    }
+
+    bool isEnabled() const
+    {
+        return !regions.empty();
+    }
+
+    /** set the simulation step which is assigned to all following regions */
+    void setStep(uint32_t const currentStep)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        step = currentStep;
+    }
+
+    /** get the current time in nanoseconds */
+    static uint64_t now()
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()
+            ).count()
+        );
+    }
+
+    /** get a persistent pointer to a copy of a runtime name
+     *
+     * The pointer is valid until the end of the program and can be used
+     * as region name.
+     */
+    char const * intern(std::string const & name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return names.insert(name).first->c_str();
+    }
+
+    /** store a region
+     *
+     * @param name name of the region
+     * @param category category of the region
+     * @param begin start time, @see now()
+     * @param end end time, @see now()
+     */
+    void add(char const * name, char const * category, uint64_t const begin, uint64_t const end)
+    {
+        if (!isEnabled())
+            return;
+        std::lock_guard<std::mutex> lock(mutex);
+        Region& region = regions[numRegions % regions.size()];
+        region.name = name;
+        region.category = category;
+        region.begin = begin;
+        region.end = end;
+        region.step = step;
+        ++numRegions;
+    }
+
+    /** sum the durations of all stored regions per name
+     *
+     * Only regions tagged with a step in [firstStep, endStep) are taken into
+     * account.
+     *
+     * @param category only regions of this category are taken into account
+     * @param firstStep first step of the window
+     * @param endStep first step after the window
+     * @return map with the region name as key and the sum of durations in nanoseconds
+     */
+    std::map<std::string, uint64_t> getDurations(
+        std::string const & category,
+        uint32_t const firstStep,
+        uint32_t const endStep
+    ) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<std::string, uint64_t> durations;
+        size_t const numStored = std::min(numRegions, static_cast<uint64_t>(regions.size()));
+        for (size_t i = 0; i < numStored; ++i)
+        {
+            Region const & region = regions[i];
+            if (region.step >= firstStep && region.step < endStep && category == region.category)
+                durations[region.name] += region.end - region.begin;
+        }
+        return durations;
+    }
+
+    /** number of regions added since init(), including overwritten regions */
+    uint64_t getNumRecorded() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return numRegions;
+    }
+
+    /** maximum number of stored regions */
+    size_t getCapacity() const
+    {
+        return regions.size();
+    }
+
+    /** write all stored regions in the Chrome trace event format
+     *
+     * The file can be opened with `chrome://tracing` or any other
+     * viewer supporting the JSON trace event format.
+     *
+     * @param fileName name of the output file
+     * @param rank id of the process, used as process id in the trace
+     */
+    void writeChromeTrace(std::string const & fileName, int const rank) const
+    {
+        std::ofstream file(fileName.c_str());
+        if (!file)
+            throw std::runtime_error(std::string("Tracer: can not open file ") + fileName);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t const numStored = std::min(numRegions, static_cast<uint64_t>(regions.size()));
+        size_t const first = numRegions - numStored;
+
+        file << "{\"traceEvents\":[" << std::endl;
+        file << std::fixed << std::setprecision(3);
+        for (size_t i = 0; i < numStored; ++i)
+        {
+            Region const & region = regions[(first + i) % regions.size()];
+            file << "{\"name\":\"" << region.name
+                << "\",\"cat\":\"" << region.category
+                << "\",\"ph\":\"X\",\"pid\":" << rank
+                << ",\"tid\":0,\"ts\":" << double(region.begin - origin) / 1000.
+                << ",\"dur\":" << double(region.end - region.begin) / 1000.
+                << ",\"args\":{\"step\":" << region.step << "}}";
+            if (i + 1 != numStored)
+                file << ",";
+            file << std::endl;
+        }
+        file << "],\"otherData\":{\"droppedRegions\":" << first << "}}" << std::endl;
+    }
+
+private:
+
+    Tracer() : numRegions(0), origin(0), step(0)
+    {
+    }
+
+    Tracer(Tracer const &);
+
+    std::vector<Region> regions;
+    /* number of regions added since init(), can be larger than the capacity */
+    uint64_t numRegions;
+    /* time of the call to init(), all written timestamps are relative to it */
+    uint64_t origin;
+    uint32_t step;
+    std::set<std::string> names;
+    /* regions are also added by background threads (e.g. plugin output) */
+    mutable std::mutex mutex;
+};
+
+/** record the lifetime of the object as region
+ *
+ * A scope can be split into consecutive phases with next().
+ */
+class TraceScope
+{
+public:
+
+    TraceScope(char const * name, char const * category) :
+        name(name), category(category), enabled(Tracer::getInstance().isEnabled()), begin(0)
+    {
+        if (enabled)
+            begin = Tracer::getInstance().now();
+    }
+
+    /** finish the current region and start a new region */
+    void next(char const * nextName)
+    {
+        if (enabled)
+        {
+            uint64_t const end = Tracer::getInstance().now();
+            Tracer::getInstance().add(name, category, begin, end);
+            begin = end;
+        }
+        name = nextName;
+    }
+
+    ~TraceScope()
+    {
+        if (enabled)
+            Tracer::getInstance().add(name, category, begin, Tracer::getInstance().now());
+    }
+
+private:
+
+    char const * name;
+    char const * category;
+    bool const enabled;
+    uint64_t begin;
+};
+
+} //namespace PMacc
+
+/** record the remaining part of the current scope as region
+ *
+ * @param name name of the region (string literal)
+ * @param category category of the region (string literal)
+ */
+#define PMACC_TRACE_SCOPE(name, category) \
+    ::PMacc::TraceScope PMACC_JOIN(pmaccTraceScope_, __LINE__)(name, category)
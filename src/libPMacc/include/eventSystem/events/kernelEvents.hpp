@@ -28,6 +28,7 @@
 #include "eventSystem/EventSystem.hpp"
 #include "Environment.hpp"
 #include "nvidia/gpuEntryFunction.hpp"
+#include "debug/Tracer.hpp"
 
 #include <string>
 
@@ -178,6 +179,10 @@ namespace exec
             T_Args const & ... args
         ) const
         {
+            PMACC_TRACE_SCOPE(
+                typeid( m_kernel.m_kernelFunctor ).name(),
+                "kernel"
+            );
 
             std::string const kernelName = typeid( m_kernel.m_kernelFunctor ).name();
             std::string const kernelInfo = kernelName +
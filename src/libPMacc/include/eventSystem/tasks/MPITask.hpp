@@ -22,6 +22,7 @@
 #pragma once
 
 #include "eventSystem/tasks/ITask.hpp"
+#include "debug/Tracer.hpp"
 
 #include <mpi.h>
 
@@ -38,19 +39,27 @@ namespace PMacc
         /**
          * Constructor.
          * Starts a MPI operation on the transaction system.
+         *
+         * @param traceName name of the task in the Tracer (string literal)
          */
-        MPITask() :
+        MPITask(char const * traceName = "MPITask") :
         ITask(),
-        finished(false)
+        finished(false),
+        traceName(traceName),
+        traceBegin(Tracer::getInstance().isEnabled() ? Tracer::now() : 0)
         {
             this->setTaskType(ITask::TASK_MPI);
         }
 
         /**
          * Destructor.
+         *
+         * The task is deleted by the Manager after it is finished,
+         * therefore the traced region covers the full MPI operation.
          */
         virtual ~MPITask()
         {
+            Tracer::getInstance().add(traceName, "mpi", traceBegin, Tracer::now());
         }
 
     protected:
@@ -74,5 +83,7 @@ namespace PMacc
         }
     private:
         bool finished;
+        char const * traceName;
+        uint64_t traceBegin;
     };
 }
@@ -38,7 +38,7 @@ class TaskReceiveMPI : public MPITask
 public:
 
     TaskReceiveMPI(Exchange<TYPE, DIM> *exchange) :
-    MPITask(),
+    MPITask("TaskReceiveMPI"),
     exchange(exchange)
     {
 
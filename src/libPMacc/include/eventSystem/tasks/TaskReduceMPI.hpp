@@ -0,0 +1,99 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "communication/manager_common.hpp"
+#include "eventSystem/tasks/MPITask.hpp"
+
+#include <mpi.h>
+#include <functional>
+#include <string>
+
+namespace PMacc
+{
+
+/** non-blocking MPI collective operation
+ *
+ * The operation is started by the creator of the task via getRequest(),
+ * the Manager tests the request each time it executes its tasks and calls
+ * the callback once the operation is finished.
+ */
+class TaskReduceMPI : public MPITask
+{
+public:
+
+    /** constructor
+     *
+     * @param callback functor called after the operation is finished
+     */
+    TaskReduceMPI(std::function<void()> const & callback) :
+    MPITask("TaskReduceMPI"),
+    request(MPI_REQUEST_NULL),
+    callback(callback)
+    {
+
+    }
+
+    virtual void init()
+    {
+
+    }
+
+    /** handle for the MPI operation of this task */
+    MPI_Request* getRequest()
+    {
+        return &request;
+    }
+
+    bool executeIntern()
+    {
+        if (this->isFinished())
+            return true;
+
+        int flag = 0;
+        MPI_CHECK(MPI_Test(&request, &flag, MPI_STATUS_IGNORE));
+
+        if (flag)
+        {
+            setFinished();
+            callback();
+            return true;
+        }
+        return false;
+    }
+
+    void event(id_t, EventType, IEventData*)
+    {
+
+    }
+
+    std::string toString()
+    {
+        return "TaskReduceMPI";
+    }
+
+private:
+    MPI_Request request;
+    std::function<void()> callback;
+};
+
+} //namespace PMacc
@@ -38,7 +38,7 @@ class TaskSendMPI : public MPITask
 public:
 
     TaskSendMPI(Exchange<TYPE, DIM> *exchange) :
-    MPITask(),
+    MPITask("TaskSendMPI"),
     exchange(exchange)
     {
 
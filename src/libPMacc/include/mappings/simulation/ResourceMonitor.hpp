@@ -22,6 +22,7 @@
 #pragma once
 #include <vector>  /* std::vector */
 #include <cstdlib> /* std::size_t */
+#include <stdint.h> /* uint64_t */
 
 namespace PMacc
 {
@@ -52,6 +53,12 @@ namespace PMacc
         template <typename T_Species, typename T_MappingDesc>
         std::vector<std::size_t> getParticleCounts(T_MappingDesc &cellDescription);
 
+        /**
+         * Returns the number of bytes sent to the neighbors since the start
+         * of the simulation, indexed by the exchange type
+         */
+        std::vector<uint64_t> getSentBytes();
+
     };
 
 } //namespace PMacc
@@ -28,6 +28,7 @@
 #include "algorithms/ForEach.hpp"
 #include "dataManagement/DataConnector.hpp"
 #include "mappings/simulation/ResourceMonitor.hpp"
+#include "traits/NumberOfExchanges.hpp"
 
 
 namespace PMacc
@@ -76,4 +77,14 @@ namespace PMacc
         return particleCounts;
     }
 
+    template<unsigned T_DIM>
+    std::vector<uint64_t> ResourceMonitor<T_DIM>::getSentBytes()
+    {
+        const CommunicatorMPI<T_DIM> & comm = Environment<T_DIM>::get().GridController().getCommunicator();
+        std::vector<uint64_t> sentBytes(NumberOfExchanges<T_DIM>::value);
+        for (uint32_t ex = 0; ex < sentBytes.size(); ++ex)
+            sentBytes[ex] = comm.getSentBytes(ex);
+        return sentBytes;
+    }
+
 } //namespace PMacc
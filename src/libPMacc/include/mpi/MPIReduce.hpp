@@ -27,8 +27,14 @@
 #include "mpi/GetMPI_Op.hpp"
 #include "assert.hpp"
 #include "pmacc_types.hpp"
+#include "Environment.hpp"
+#include "eventSystem/tasks/TaskReduceMPI.hpp"
+#include "eventSystem/events/EventTask.hpp"
 
 #include <mpi.h>
+#include <vector>
+#include <memory>
+#include <algorithm>
 
 
 namespace PMacc
@@ -185,6 +191,61 @@ struct MPIReduce
     }
 
 
+    /** start a non-blocking reduction of elements on cpu memory
+     *
+     * The input is copied, src can be reused after the call. The operation
+     * is progressed by the event system, the callback is called on all
+     * ranks of this reduction after the operation is finished. All ranks
+     * must start their asynchronous and blocking reductions of this object
+     * in the same order. Requires MPI 3.
+     *
+     * @param func binary functor for reduce, @see operator()
+     * @param src pointer to the elements to reduce
+     * @param n number of elements to reduce
+     * @param method mpi method for reduce
+     * @param callback functor with the signature `void(Type const * result)`,
+     *                 result is nullptr on ranks where hasResult(method) is false
+     *                 and is only valid during the call
+     * @return event of the operation, wait for it before the callback
+     *         accesses objects which could be destroyed
+     */
+    template<class Functor, typename Type, class ReduceMethod, class Callback >
+    HINLINE EventTask async(Functor func,
+                            Type const * src,
+                            const size_t n,
+                            const ReduceMethod method,
+                            Callback callback)
+    {
+        if (!isMPICommInitialized)
+            participate(true);
+        typedef Type ValueType;
+
+        /* input and result, kept alive by the task until the callback is finished */
+        std::shared_ptr< std::vector< ValueType > > buffer( new std::vector< ValueType >(2 * n) );
+        std::copy(src, src + n, buffer->begin());
+        const bool withResult = method.hasResult(mpiRank);
+
+        TaskReduceMPI* task = new TaskReduceMPI(
+            [buffer, n, withResult, callback]()
+            {
+                callback(withResult ? &(*buffer)[n] : static_cast<ValueType const *>(nullptr));
+            }
+        );
+        method.start(func,
+                     &(*buffer)[n],
+                     &(*buffer)[0],
+                     n * ::PMacc::mpi::getMPI_StructAsArray<ValueType > ().sizeMultiplier,
+                     ::PMacc::mpi::getMPI_StructAsArray<ValueType > ().dataType,
+                     ::PMacc::mpi::getMPI_Op<Functor > (),
+                     comm,
+                     task->getRequest());
+
+        EventTask event(task->getId());
+        task->init();
+        Environment<>::get().Manager().addTask(task);
+        return event;
+    }
+
 private:
 
     MPI_Comm comm;
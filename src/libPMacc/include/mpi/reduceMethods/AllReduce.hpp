@@ -50,6 +50,21 @@ struct AllReduce
                                 type,
                                 op, comm));
     }
+
+    /** start a non-blocking reduction (MPI 3), arguments as for operator()
+     *
+     * @param request handle of the started operation
+     */
+    template<class Functor, typename Type >
+    HINLINE void start(Functor, Type* dest, Type* src, const size_t count, MPI_Datatype type, MPI_Op op, MPI_Comm comm,
+                       MPI_Request* request) const
+    {
+        MPI_CHECK(MPI_Iallreduce((void*) src,
+                                 (void*) dest,
+                                 count,
+                                 type,
+                                 op, comm, request));
+    }
 };
 
 } /*namespace reduceMethods*/
@@ -24,6 +24,7 @@
 
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <boost/program_options/options_description.hpp>
 
@@ -148,7 +149,43 @@ namespace PMacc
             lastCheckpoint = currentStep;
         }
 
+        /** Does this rank write its checkpoint data to files of its own?
+         *
+         * Backends writing one shared file with all ranks (e.g. parallel HDF5)
+         * must return false, they can not be staged in node-local storage.
+         *
+         * @return true if no other rank writes to the files of this rank
+         */
+        virtual bool hasRankLocalCheckpointFiles() const
+        {
+            return true;
+        }
+
+        /** Files written by this rank during the last checkpoint call
+         *
+         * @return file names relative to the checkpoint directory
+         */
+        const std::vector<std::string>& getCheckpointFiles() const
+        {
+            return checkpointFiles;
+        }
+
+        /** Forget the files of the previous checkpoint call */
+        void clearCheckpointFiles()
+        {
+            checkpointFiles.clear();
+        }
+
     protected:
+        /** Report a file written during checkpoint()
+         *
+         * @param filename file name relative to the checkpoint directory
+         */
+        void addCheckpointFile(const std::string& filename)
+        {
+            checkpointFiles.push_back(filename);
+        }
+
         virtual void pluginLoad()
         {
             /* override this function if necessary */
@@ -161,5 +198,6 @@ namespace PMacc
 
         bool loaded;
         uint32_t lastCheckpoint;
+        std::vector<std::string> checkpointFiles;
     };
 }
@@ -24,9 +24,11 @@
 
 #include "pluginSystem/INotify.hpp"
 #include "pluginSystem/IPlugin.hpp"
+#include "debug/Tracer.hpp"
 
 #include <vector>
 #include <list>
+#include <string>
 
 namespace PMacc
 {
@@ -144,6 +146,14 @@ namespace PMacc
                 uint32_t period = iter->second;
                 if (currentStep % period == 0)
                 {
+                    char const * traceName = "notify";
+                    if (Tracer::getInstance().isEnabled())
+                    {
+                        IPlugin* plugin = dynamic_cast<IPlugin*>(notifiedObj);
+                        if (plugin != nullptr)
+                            traceName = Tracer::getInstance().intern(plugin->pluginGetName());
+                    }
+                    TraceScope traceNotify(traceName, "plugin");
                     notifiedObj->notify(currentStep);
                     notifiedObj->setLastNotify(currentStep);
                 }
@@ -161,11 +171,45 @@ namespace PMacc
             for (std::list<IPlugin*>::iterator iter = plugins.begin();
                     iter != plugins.end(); ++iter)
             {
+                (*iter)->clearCheckpointFiles();
                 (*iter)->checkpoint(currentStep, checkpointDirectory);
                 (*iter)->setLastCheckpoint(currentStep);
             }
         }
 
+        /**
+         * Check if each plugin writes checkpoint files of its own per rank.
+         *
+         * @return false if a plugin shares checkpoint files between ranks
+         */
+        bool hasRankLocalCheckpointFiles() const
+        {
+            for (std::list<IPlugin*>::const_iterator iter = plugins.begin();
+                    iter != plugins.end(); ++iter)
+            {
+                if (!(*iter)->hasRankLocalCheckpointFiles())
+                    return false;
+            }
+            return true;
+        }
+
+        /**
+         * Get the files all plugins wrote on this rank during the last checkpoint.
+         *
+         * @return file names relative to the checkpoint directory
+         */
+        std::vector<std::string> getCheckpointFiles() const
+        {
+            std::vector<std::string> files;
+            for (std::list<IPlugin*>::const_iterator iter = plugins.begin();
+                    iter != plugins.end(); ++iter)
+            {
+                const std::vector<std::string>& pluginFiles = (*iter)->getCheckpointFiles();
+                files.insert(files.end(), pluginFiles.begin(), pluginFiles.end());
+            }
+            return files;
+        }
+
         /**
          * Notifies plugins that a restart is required.
          *
@@ -0,0 +1,365 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "Environment.hpp"
+#include "mappings/simulation/GridController.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+
+namespace PMacc
+{
+
+/** node-local tier for checkpoints
+ *
+ * Checkpoints are written to a node-local directory (e.g. tmpfs or NVMe) and
+ * copied (drained) to the global checkpoint directory by a background thread.
+ * Each rank drains the files it wrote, as reported by the checkpoint plugins.
+ * After a drain only the files of the latest checkpoint are kept in the local
+ * directory.
+ *
+ * Optionally each rank sends the files of a checkpoint to the rank with the
+ * same host rank on the next node, which keeps them in the sub directory
+ * `partner/<rank>` of its local directory. A checkpoint survives the loss of
+ * one node before it is drained.
+ *
+ * Each file must be written by one rank only, backends writing a file shared
+ * by several ranks can not be used with this tier.
+ *
+ * @tparam DIM dimension of the simulation
+ */
+template<unsigned DIM>
+class LocalCheckpointTier
+{
+public:
+
+    LocalCheckpointTier() :
+        partnerCopy(false),
+        partnerDest(-1),
+        partnerSource(-1),
+        pendingStep(-1)
+    {
+    }
+
+    ~LocalCheckpointTier()
+    {
+        /* MPI can already be finalized, only finish the local file copies */
+        if (drainThread.joinable())
+            drainThread.join();
+    }
+
+    /** enable the tier, must be called by all ranks
+     *
+     * @param localDir node-local directory for writing checkpoints
+     * @param globalDir directory on the parallel filesystem
+     * @param copyToPartner send the files of each checkpoint to a rank on the next node
+     */
+    void init(const std::string& localDir, const std::string& globalDir, const bool copyToPartner)
+    {
+        localDirectory = localDir;
+        globalDirectory = globalDir;
+        partnerCopy = copyToPartner;
+
+        if (partnerCopy)
+            findPartners();
+    }
+
+    bool isEnabled() const
+    {
+        return !localDirectory.empty();
+    }
+
+    /** directory where the checkpoint plugins write to */
+    const std::string& getDirectory() const
+    {
+        return localDirectory;
+    }
+
+    /** start to drain a checkpoint written to the local directory
+     *
+     * Must be called by all ranks after all ranks finished writing. The
+     * partner copy is done before the method returns, the copy to the
+     * global directory runs in the background.
+     *
+     * @param step checkpoint step
+     * @param files files written by this rank, relative to the local directory
+     */
+    void startDrain(const uint32_t step, const std::vector<std::string>& files)
+    {
+        pendingStep = step;
+
+        if (partnerCopy && partnerDest >= 0)
+            exchangeWithPartner(files);
+
+        drainError.clear();
+        drainThread = boost::thread([this, files]() { this->drain(files); });
+    }
+
+    /** wait until the last checkpoint is drained on all ranks
+     *
+     * Must be called by all ranks.
+     *
+     * @return step of the drained checkpoint, -1 if no checkpoint was pending
+     */
+    int64_t finishDrain()
+    {
+        if (pendingStep < 0)
+            return -1;
+
+        if (drainThread.joinable())
+            drainThread.join();
+
+        GridController<DIM>& gc = Environment<DIM>::get().GridController();
+        int failed = drainError.empty() ? 0 : 1;
+        int anyFailed = 0;
+        MPI_CHECK(MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_MAX,
+                                gc.getCommunicator().getMPIComm()));
+
+        const int64_t step = pendingStep;
+        pendingStep = -1;
+
+        if (failed)
+            std::cerr << "LocalCheckpointTier: " << drainError << std::endl;
+        if (anyFailed)
+            throw std::runtime_error("LocalCheckpointTier: failed to drain checkpoint to " + globalDirectory);
+
+        return step;
+    }
+
+private:
+
+    /** sub directory of the local directory containing the files of a partner rank
+     *
+     * @param sourceRank global rank which sent the files
+     */
+    std::string getPartnerDirectory(const int sourceRank) const
+    {
+        std::stringstream dir;
+        dir << localDirectory << "/partner/" << sourceRank;
+        return dir.str();
+    }
+
+    /** select the ranks to send to and to receive from
+     *
+     * The ranks are grouped by their processor name. Each rank sends to the
+     * rank with the same host rank on the next node and receives from the
+     * previous node, therefore all nodes must run the same number of ranks.
+     */
+    void findPartners()
+    {
+        GridController<DIM>& gc = Environment<DIM>::get().GridController();
+        MPI_Comm comm = gc.getCommunicator().getMPIComm();
+
+        int numRanks = 0;
+        int rank = 0;
+        MPI_CHECK(MPI_Comm_size(comm, &numRanks));
+        MPI_CHECK(MPI_Comm_rank(comm, &rank));
+
+        char hostname[MPI_MAX_PROCESSOR_NAME] = {0};
+        int length = 0;
+        MPI_CHECK(MPI_Get_processor_name(hostname, &length));
+
+        std::vector<char> allHostnames(size_t(numRanks) * MPI_MAX_PROCESSOR_NAME);
+        MPI_CHECK(MPI_Allgather(hostname, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                                &allHostnames[0], MPI_MAX_PROCESSOR_NAME, MPI_CHAR, comm));
+
+        /* ranks of each node in the order of their first rank */
+        std::vector<std::vector<int> > nodes;
+        std::map<std::string, size_t> nodeIds;
+        int myNode = 0;
+        int myHostRank = 0;
+        for (int i = 0; i < numRanks; ++i)
+        {
+            const std::string name(&allHostnames[size_t(i) * MPI_MAX_PROCESSOR_NAME]);
+            std::map<std::string, size_t>::const_iterator known = nodeIds.find(name);
+            if (known == nodeIds.end())
+            {
+                known = nodeIds.insert(std::make_pair(name, nodes.size())).first;
+                nodes.push_back(std::vector<int>());
+            }
+            if (i == rank)
+            {
+                myNode = int(known->second);
+                myHostRank = int(nodes[known->second].size());
+            }
+            nodes[known->second].push_back(i);
+        }
+
+        const int numNodes = int(nodes.size());
+        for (int i = 0; i < numNodes; ++i)
+        {
+            if (nodes[i].size() != nodes[0].size())
+                throw std::runtime_error("LocalCheckpointTier: the partner copy requires the same number "
+                                         "of ranks on each node");
+        }
+
+        if (numNodes < 2)
+        {
+            if (rank == 0)
+                std::cerr << "LocalCheckpointTier: only one node, the partner copy is disabled" << std::endl;
+            return;
+        }
+
+        partnerDest = nodes[(myNode + 1) % numNodes][myHostRank];
+        partnerSource = nodes[(myNode + numNodes - 1) % numNodes][myHostRank];
+    }
+
+    /** send files to the partner rank and receive the files of the source rank
+     *
+     * The files are transferred in chunks via MPI_Sendrecv, only the latest
+     * checkpoint of the source rank is kept.
+     */
+    void exchangeWithPartner(const std::vector<std::string>& files)
+    {
+        namespace bfs = boost::filesystem;
+
+        MPI_Comm comm = Environment<DIM>::get().GridController().getCommunicator().getMPIComm();
+        const int tag = 0;
+        const uint64_t chunkSize = 64llu * 1024llu * 1024llu;
+
+        const bfs::path partnerDir(getPartnerDirectory(partnerSource));
+        bfs::remove_all(partnerDir);
+        bfs::create_directories(partnerDir);
+
+        uint64_t numSend = files.size();
+        uint64_t numRecv = 0;
+        MPI_CHECK(MPI_Sendrecv(&numSend, 1, MPI_UINT64_T, partnerDest, tag,
+                               &numRecv, 1, MPI_UINT64_T, partnerSource, tag,
+                               comm, MPI_STATUS_IGNORE));
+
+        std::vector<char> sendBuffer(chunkSize);
+        std::vector<char> recvBuffer(chunkSize);
+        for (uint64_t i = 0; i < std::max(numSend, numRecv); ++i)
+        {
+            /* header: length of the path and size of the file, zero if all files are sent */
+            uint64_t sendHeader[2] = {0, 0};
+            uint64_t recvHeader[2] = {0, 0};
+            std::ifstream in;
+            if (i < numSend)
+            {
+                const bfs::path path(bfs::path(localDirectory) / files[i]);
+                sendHeader[0] = files[i].size();
+                sendHeader[1] = bfs::file_size(path);
+                in.open(path.string().c_str(), std::ios::binary);
+            }
+            MPI_CHECK(MPI_Sendrecv(sendHeader, 2, MPI_UINT64_T, partnerDest, tag,
+                                   recvHeader, 2, MPI_UINT64_T, partnerSource, tag,
+                                   comm, MPI_STATUS_IGNORE));
+
+            std::string recvName(recvHeader[0], '\0');
+            MPI_CHECK(MPI_Sendrecv(const_cast<char*>(i < numSend ? files[i].c_str() : ""), int(sendHeader[0]),
+                                   MPI_CHAR, partnerDest, tag,
+                                   &recvName[0], int(recvHeader[0]), MPI_CHAR, partnerSource, tag,
+                                   comm, MPI_STATUS_IGNORE));
+
+            std::ofstream out;
+            if (i < numRecv)
+            {
+                const bfs::path target(partnerDir / recvName);
+                bfs::create_directories(target.parent_path());
+                out.open(target.string().c_str(), std::ios::binary);
+            }
+
+            uint64_t sendLeft = sendHeader[1];
+            uint64_t recvLeft = recvHeader[1];
+            while (sendLeft != 0 || recvLeft != 0)
+            {
+                const uint64_t sendCount = std::min(sendLeft, chunkSize);
+                const uint64_t recvCount = std::min(recvLeft, chunkSize);
+                if (sendCount != 0)
+                    in.read(&sendBuffer[0], sendCount);
+                MPI_CHECK(MPI_Sendrecv(&sendBuffer[0], int(sendCount), MPI_CHAR, partnerDest, tag,
+                                       &recvBuffer[0], int(recvCount), MPI_CHAR, partnerSource, tag,
+                                       comm, MPI_STATUS_IGNORE));
+                if (recvCount != 0)
+                    out.write(&recvBuffer[0], recvCount);
+                sendLeft -= sendCount;
+                recvLeft -= recvCount;
+            }
+        }
+    }
+
+    /** copy files to the global directory and remove older local files
+     *
+     * Executed by the drain thread, errors are stored in drainError.
+     */
+    void drain(const std::vector<std::string>& files)
+    {
+        namespace bfs = boost::filesystem;
+
+        try
+        {
+            for (size_t i = 0; i < files.size(); ++i)
+            {
+                const bfs::path target(bfs::path(globalDirectory) / files[i]);
+                bfs::create_directories(target.parent_path());
+                bfs::copy_file(bfs::path(localDirectory) / files[i], target,
+                               bfs::copy_option::overwrite_if_exists);
+            }
+
+            /* keep only the latest checkpoint in the local directory */
+            const std::set<std::string> latest(files.begin(), files.end());
+            for (std::set<std::string>::const_iterator it = drainedFiles.begin(); it != drainedFiles.end(); ++it)
+            {
+                if (latest.count(*it) == 0)
+                    bfs::remove(bfs::path(localDirectory) / *it);
+            }
+            drainedFiles = latest;
+        }
+        catch (const std::exception& e)
+        {
+            drainError = e.what();
+        }
+    }
+
+    std::string localDirectory;
+    std::string globalDirectory;
+    bool partnerCopy;
+
+    /* global rank receiving the files of this rank, -1 if none */
+    int partnerDest;
+    /* global rank sending its files to this rank, -1 if none */
+    int partnerSource;
+
+    /* step of the checkpoint which is drained, -1 if none */
+    int64_t pendingStep;
+    boost::thread drainThread;
+    /* error message of the drain thread, empty on success */
+    std::string drainError;
+    /* files of the last drained checkpoint, relative to the local directory */
+    std::set<std::string> drainedFiles;
+};
+
+} //namespace PMacc
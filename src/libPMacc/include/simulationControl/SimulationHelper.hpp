@@ -31,10 +31,15 @@
 #include "dataManagement/DataConnector.hpp"
 #include "Environment.hpp"
 #include "pluginSystem/IPlugin.hpp"
+#include "debug/Tracer.hpp"
+#include "simulationControl/StartupScheduler.hpp"
+#include "simulationControl/LocalCheckpointTier.hpp"
 #include <boost/filesystem.hpp>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <sstream>
+#include <stdexcept>
 
 namespace PMacc
 {
@@ -60,12 +65,16 @@ public:
     runSteps(0),
     checkpointPeriod(0),
     checkpointDirectory("checkpoints"),
+    checkpointLocalDirectory(""),
+    checkpointPartnerCopy(false),
     numCheckpoints(0),
     restartStep(-1),
     restartDirectory("checkpoints"),
     restartRequested(false),
     CHECKPOINT_MASTER_FILE("checkpoints.txt"),
-    author("")
+    author(""),
+    traceRegions(0),
+    traceFile("trace")
     {
         tSimulation.toggleStart();
         tInit.toggleStart();
@@ -136,6 +145,8 @@ public:
         /* trigger checkpoint notification */
         if (checkpointPeriod && (currentStep % checkpointPeriod == 0))
         {
+            PMACC_TRACE_SCOPE("checkpoint", "simulation");
+
             /* first synchronize: if something failed, we can spare the time
              * for the checkpoint writing */
             CUDA_CHECK(cudaDeviceSynchronize());
@@ -149,13 +160,21 @@ public:
              * time for checkpointing if some ranks died */
             MPI_CHECK(MPI_Barrier(gc.getCommunicator().getMPIComm()));
 
+            /* the node-local directory is reused, the previous checkpoint
+             * must be in the global directory before it is overwritten */
+            finishLocalCheckpoint();
+
             /* create directory containing checkpoints  */
             if (numCheckpoints == 0)
             {
                 Environment<DIM>::get().Filesystem().createDirectoryWithPermissions(checkpointDirectory);
+                if (localCheckpointTier.isEnabled())
+                    boost::filesystem::create_directories(localCheckpointTier.getDirectory());
             }
 
             Environment<DIM>::get().PluginConnector().checkpointPlugins(currentStep,
+                                                                        localCheckpointTier.isEnabled() ?
+                                                                        localCheckpointTier.getDirectory() :
                                                                         checkpointDirectory);
 
             /* important synchronize: only if no errors occured until this
@@ -171,7 +190,14 @@ public:
              * that could be checked */
             MPI_CHECK(MPI_Barrier(gc.getCommunicator().getMPIComm()));
 
-            if (gc.getGlobalRank() == 0)
+            /* a checkpoint in the node-local directory is added to the master
+             * file after it is drained to the checkpoint directory */
+            if (localCheckpointTier.isEnabled())
+            {
+                localCheckpointTier.startDrain(currentStep,
+                                               Environment<DIM>::get().PluginConnector().getCheckpointFiles());
+            }
+            else if (gc.getGlobalRank() == 0)
             {
                 writeCheckpointStep(currentStep);
             }
@@ -227,6 +253,10 @@ public:
                     " = " <<
                     (int) (tInit.getInterval() / 1000.) << " sec" << std::endl;
             }
+            StartupScheduler::getInstance().printBreakdown(
+                getGridController().getCommunicator().getMPIComm(),
+                output
+            );
 
             TimeIntervall tSimCalculation;
             TimeIntervall tRound;
@@ -259,23 +289,31 @@ public:
              */
             while (currentStep < Environment<>::get().SimulationDescription().getRunSteps())
             {
+                Tracer::getInstance().setStep(currentStep);
                 tRound.toggleStart();
-                runOneStep(currentStep);
+                {
+                    PMACC_TRACE_SCOPE("runOneStep", "simulation");
+                    runOneStep(currentStep);
+                }
                 tRound.toggleEnd();
                 roundAvg += tRound.getInterval();
 
                 currentStep++;
                 Environment<>::get().SimulationDescription().setCurrentStep( currentStep );
+                Tracer::getInstance().setStep(currentStep);
                 /*output after a round*/
                 dumpTimes(tSimCalculation, tRound, roundAvg, currentStep);
 
+                TraceScope tracePhase("movingWindowCheck", "simulation");
                 movingWindowCheck(currentStep);
                 /*dump after simulated step*/
+                tracePhase.next("dumpOneStep");
                 dumpOneStep(currentStep);
             }
 
             // simulatation end
             Environment<>::get().Manager().waitForAllTasks();
+            finishLocalCheckpoint();
 
             tSimCalculation.toggleEnd();
 
@@ -287,6 +325,15 @@ public:
             }
 
         } // softRestarts loop
+
+        /* written once, the regions of all soft restarts are in one file */
+        if (Tracer::getInstance().isEnabled())
+        {
+            const int rank = getGridController().getGlobalRank();
+            std::stringstream fileName;
+            fileName << traceFile << "_" << rank << ".json";
+            Tracer::getInstance().writeChromeTrace(fileName.str(), rank);
+        }
     }
 
     virtual void pluginRegisterHelp(po::options_description& desc)
@@ -305,8 +352,21 @@ public:
             ("checkpoints", po::value<uint32_t>(&checkpointPeriod), "Period for checkpoint creation")
             ("checkpoint-directory", po::value<std::string>(&checkpointDirectory)->default_value(checkpointDirectory),
              "Directory for checkpoints")
+            ("checkpoint-local-directory", po::value<std::string>(&checkpointLocalDirectory)->default_value(checkpointLocalDirectory),
+             "Node-local directory (e.g. tmpfs, NVMe) for writing checkpoints, the files are copied "
+             "to the checkpoint directory in the background [empty = disabled]. "
+             "Each checkpoint file must be written by one rank: the default parallel HDF5 checkpoints "
+             "are rejected, use ADIOS with --adios.checkpoint-posix")
+            ("checkpoint-partner-copy", po::value<bool>(&checkpointPartnerCopy)->zero_tokens(),
+             "Copy the node-local checkpoint files of each rank to a rank on the next node")
             ("author", po::value<std::string>(&author)->default_value(std::string("")),
-             "The author that runs the simulation and is responsible for created output files");
+             "The author that runs the simulation and is responsible for created output files")
+            ("trace-regions", po::value<uint32_t>(&traceRegions)->default_value(traceRegions),
+             "Number of timed regions (kernels, MPI tasks, simulation phases, plugins) "
+             "kept per rank, the oldest regions are overwritten, the phaseTime of resourceLog "
+             "needs all regions of one resourceLog.period [0 = disabled]")
+            ("trace-file", po::value<std::string>(&traceFile)->default_value(traceFile),
+             "Prefix for the per rank trace files in the Chrome trace event format");
     }
 
     std::string pluginGetName() const
@@ -321,6 +381,16 @@ public:
 
         calcProgress();
 
+        Tracer::getInstance().init(traceRegions);
+
+        if (!checkpointLocalDirectory.empty())
+        {
+            if (!Environment<>::get().PluginConnector().hasRankLocalCheckpointFiles())
+                throw std::runtime_error("checkpoint-local-directory: all checkpoint plugins must write "
+                                         "one file per rank (e.g. --adios.checkpoint-posix)");
+            localCheckpointTier.init(checkpointLocalDirectory, checkpointDirectory, checkpointPartnerCopy);
+        }
+
         output = (getGridController().getGlobalRank() == 0);
     }
 
@@ -350,6 +420,15 @@ protected:
     /* common directory for checkpoints */
     std::string checkpointDirectory;
 
+    /* node-local directory for checkpoints, empty if not used */
+    std::string checkpointLocalDirectory;
+
+    /* copy node-local checkpoints to a rank on the next node */
+    bool checkpointPartnerCopy;
+
+    /* drains node-local checkpoints to checkpointDirectory */
+    LocalCheckpointTier<DIM> localCheckpointTier;
+
     /* number of checkpoints written */
     uint32_t numCheckpoints;
 
@@ -368,6 +447,12 @@ protected:
     /* author that runs the simulation */
     std::string author;
 
+    /* number of regions kept by the Tracer, 0 disables tracing */
+    uint32_t traceRegions;
+
+    /* prefix for the trace files */
+    std::string traceFile;
+
 private:
 
     /**
@@ -388,6 +473,19 @@ private:
             showProgressAnyStep = 1;
     }
 
+    /**
+     * Wait until the last node-local checkpoint is drained and append it to
+     * the master checkpoint file, must be called by all ranks
+     */
+    void finishLocalCheckpoint()
+    {
+        const int64_t drainedStep = localCheckpointTier.finishDrain();
+        if (drainedStep >= 0 && getGridController().getGlobalRank() == 0)
+        {
+            writeCheckpointStep(uint32_t(drainedStep));
+        }
+    }
+
     /**
      * Append \p checkpointStep to the master checkpoint file
      *
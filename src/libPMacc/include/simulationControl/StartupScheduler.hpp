@@ -0,0 +1,233 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "debug/Tracer.hpp"
+#include "communication/manager_common.hpp"
+
+#include <mpi.h>
+#include <future>
+#include <functional>
+#include <exception>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <stdint.h>
+
+namespace PMacc
+{
+
+/** schedule and time the stages of the simulation startup
+ *
+ * Stages on the main thread are timed with StartupStage.
+ * Host stages run concurrently on an own thread each and are joined with
+ * waitForHostStages(). A host stage must not use CUDA or any PMacc
+ * object (buffers, task manager, environment), these are not thread safe.
+ *
+ * All stages are also added to the Tracer with the category `init`.
+ */
+class StartupScheduler
+{
+public:
+
+    static StartupScheduler& getInstance()
+    {
+        static StartupScheduler instance;
+        return instance;
+    }
+
+    /** start a host stage on an own thread
+     *
+     * @param name name of the stage (string literal)
+     * @param task work of the stage, exceptions are thrown by waitForHostStages()
+     */
+    void startHostStage(char const * name, std::function<void()> const & task)
+    {
+        HostStage stage;
+        stage.name = name;
+        stage.result = std::async(
+            std::launch::async,
+            [task]()
+            {
+                Interval interval;
+                interval.first = Tracer::now();
+                task();
+                interval.second = Tracer::now();
+                return interval;
+            }
+        );
+        hostStages.push_back(std::move(stage));
+    }
+
+    /** true if host stages are started and not yet joined */
+    bool hasHostStages() const
+    {
+        return !hostStages.empty();
+    }
+
+    /** join all started host stages
+     *
+     * The time waited on the main thread is stored as the stage `waitForHostStages`.
+     * If a stage failed, its exception is thrown after all stages are joined.
+     */
+    void waitForHostStages()
+    {
+        StartupStage stage("waitForHostStages");
+        std::exception_ptr error;
+        for (size_t i = 0; i < hostStages.size(); ++i)
+        {
+            try
+            {
+                Interval const interval = hostStages[i].result.get();
+                add(hostStages[i].name, true, interval.first, interval.second);
+            }
+            catch (...)
+            {
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+        hostStages.clear();
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    /** store a finished stage
+     *
+     * @param name name of the stage
+     * @param isHostStage true if the stage was executed concurrently
+     * @param begin start time, @see Tracer::now()
+     * @param end end time, @see Tracer::now()
+     */
+    void add(char const * name, bool const isHostStage, uint64_t const begin, uint64_t const end)
+    {
+        Stage stage = {name, isHostStage, end - begin};
+        stages.push_back(stage);
+        Tracer::getInstance().add(name, "init", begin, end);
+    }
+
+    /** print the duration of all finished stages and remove them
+     *
+     * Collective call: all ranks must have finished the same stages in the same order.
+     *
+     * @param comm communicator of all ranks
+     * @param output true on the rank which prints the breakdown
+     */
+    void printBreakdown(MPI_Comm comm, bool const output)
+    {
+        std::vector<double> durations(stages.size());
+        for (size_t i = 0; i < stages.size(); ++i)
+            durations[i] = double(stages[i].duration) * 1.e-6;
+
+        int numRanks = 1;
+        MPI_CHECK(MPI_Comm_size(comm, &numRanks));
+        std::vector<double> maxDurations(stages.size());
+        std::vector<double> sumDurations(stages.size());
+        if (!stages.empty())
+        {
+            MPI_CHECK(MPI_Reduce(&(*durations.begin()), &(*maxDurations.begin()), int(stages.size()),
+                                 MPI_DOUBLE, MPI_MAX, 0, comm));
+            MPI_CHECK(MPI_Reduce(&(*durations.begin()), &(*sumDurations.begin()), int(stages.size()),
+                                 MPI_DOUBLE, MPI_SUM, 0, comm));
+        }
+
+        if (output && !stages.empty())
+        {
+            std::cout << "initialization stages [ms] (max, mean over ranks):" << std::endl;
+            std::cout << std::fixed << std::setprecision(1);
+            for (size_t i = 0; i < stages.size(); ++i)
+            {
+                std::cout << "  " << std::left << std::setw(32) << stages[i].name << std::right
+                    << std::setw(12) << maxDurations[i]
+                    << std::setw(12) << sumDurations[i] / double(numRanks)
+                    << (stages[i].isHostStage ? "  (concurrent)" : "") << std::endl;
+            }
+            std::cout.unsetf(std::ios_base::floatfield);
+        }
+        stages.clear();
+    }
+
+    /** record the lifetime of the object as stage of the main thread
+     *
+     * A scope can be split into consecutive stages with next().
+     */
+    class StartupStage
+    {
+    public:
+
+        StartupStage(char const * name) : name(name), begin(Tracer::now())
+        {
+        }
+
+        /** finish the current stage and start a new stage */
+        void next(char const * nextName)
+        {
+            uint64_t const end = Tracer::now();
+            StartupScheduler::getInstance().add(name, false, begin, end);
+            begin = end;
+            name = nextName;
+        }
+
+        ~StartupStage()
+        {
+            StartupScheduler::getInstance().add(name, false, begin, Tracer::now());
+        }
+
+    private:
+
+        char const * name;
+        uint64_t begin;
+    };
+
+private:
+
+    typedef std::pair<uint64_t, uint64_t> Interval;
+
+    struct Stage
+    {
+        char const * name;
+        bool isHostStage;
+        /* duration in nanoseconds */
+        uint64_t duration;
+    };
+
+    struct HostStage
+    {
+        char const * name;
+        std::future<Interval> result;
+    };
+
+    StartupScheduler()
+    {
+    }
+
+    StartupScheduler(StartupScheduler const &);
+
+    std::vector<Stage> stages;
+    std::vector<HostStage> hostStages;
+};
+
+typedef StartupScheduler::StartupStage StartupStage;
+
+} //namespace PMacc
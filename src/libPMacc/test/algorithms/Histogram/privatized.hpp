@@ -0,0 +1,151 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/* #includes in "test/algorithmsUT.cu" */
+
+namespace
+{
+    /** bin of an item, all items in one bin if spread is zero */
+    HDINLINE int getTestBin(uint32_t const item, int const numBins, int const spread)
+    {
+        return spread == 0 ? 3 % numBins : int((item * 7u) % uint32_t(numBins));
+    }
+
+    struct TestBinValue
+    {
+        int numBins;
+        int spread;
+
+        bool operator()(size_t const item, int& bin, double& value) const
+        {
+            /* every fifth item is not binned */
+            if (item % 5u == 4u)
+                return false;
+            bin = getTestBin(uint32_t(item), numBins, spread);
+            value = 0.5;
+            return true;
+        }
+    };
+
+    struct AddToBox
+    {
+        int* ptr;
+
+        DINLINE void operator()(int const bin, int const value) const
+        {
+            atomicAdd(ptr + bin, value);
+        }
+    };
+
+    struct KernelFillHistogram
+    {
+        template<class T_Box>
+        DINLINE void operator()(
+            T_Box result,
+            uint32_t const numItems,
+            int const numBins,
+            int const numCopies,
+            int const spread
+        ) const
+        {
+            extern __shared__ int shHistogram[];
+            const int worker = threadIdx.x;
+            const int numWorkers = blockDim.x;
+
+            ::PMacc::algorithms::histogram::PrivatizedHistogram<int> histogram(shHistogram, numBins, numCopies);
+            histogram.init(worker, numWorkers);
+            __syncthreads();
+
+            const ::PMacc::algorithms::histogram::PrivatizedHistogram<int>::Copy copy = histogram.getCopy(worker);
+            ::PMacc::algorithms::histogram::BinCache<int> cache;
+            for (uint32_t i = blockIdx.x * blockDim.x + worker; i < numItems; i += gridDim.x * blockDim.x)
+                cache.add(getTestBin(i, numBins, spread), 1, copy);
+            cache.flush(copy);
+            __syncthreads();
+
+            const AddToBox addToBox = {&(result[0])};
+            histogram.merge(worker, numWorkers, addToBox);
+        }
+    };
+}
+
+/**
+ * Checks the host fill with a private copy per thread against a serial
+ * histogram, for items spread over all bins and for all items in one bin.
+ */
+BOOST_AUTO_TEST_CASE( fillHost )
+{
+    constexpr int numBins = 17;
+    constexpr size_t numItems = 10007;
+
+    for (int spread = 0; spread < 2; ++spread)
+    {
+        const TestBinValue binValue = {numBins, spread};
+        std::vector<double> expected(numBins, 0.0);
+        for (size_t i = 0; i < numItems; ++i)
+        {
+            int bin = 0;
+            double value = 0.0;
+            if (binValue(i, bin, value))
+                expected[bin] += value;
+        }
+
+        /* the histogram is added to the existing values */
+        std::vector<double> result(numBins, 1.0);
+        ::PMacc::algorithms::histogram::fillHost(&result[0], numBins, numItems, binValue);
+        for (int bin = 0; bin < numBins; ++bin)
+            BOOST_CHECK_EQUAL( result[bin], expected[bin] + 1.0 );
+    }
+}
+
+/**
+ * Checks the device histogram with a register cache per thread and one or
+ * more shared memory copies per block.
+ */
+BOOST_AUTO_TEST_CASE( fillDevice )
+{
+    constexpr int numBins = 33;
+    constexpr uint32_t numItems = 100000;
+    constexpr uint32_t numBlocks = 8;
+    constexpr uint32_t numThreadsPerBlock = 128;
+
+    for (int numCopies = 1; numCopies <= 4; numCopies *= 4)
+        for (int spread = 0; spread < 2; ++spread)
+        {
+            std::vector<int> expected(numBins, 0);
+            for (uint32_t i = 0; i < numItems; ++i)
+                ++expected[getTestBin(i, numBins, spread)];
+
+            ::PMacc::HostDeviceBuffer<int, 1> result(numBins);
+            result.getDeviceBuffer().setValue(0);
+            const size_t sharedMemSize = sizeof(int) *
+                ::PMacc::algorithms::histogram::PrivatizedHistogram<int>::getSize(numBins, numCopies);
+            PMACC_KERNEL(KernelFillHistogram{})(numBlocks, numThreadsPerBlock, sharedMemSize)
+                (result.getDeviceBuffer().getDataBox(), numItems, numBins, numCopies, spread);
+            result.deviceToHost();
+
+            auto hostBox = result.getHostBuffer().getDataBox();
+            for (int bin = 0; bin < numBins; ++bin)
+                BOOST_CHECK_EQUAL( hostBox(bin), expected[bin] );
+        }
+}
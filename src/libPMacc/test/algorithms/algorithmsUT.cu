@@ -0,0 +1,50 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PMaccFixture.hpp"
+
+// STL
+#include <stdint.h>
+#include <vector>
+
+// BOOST
+#include <boost/test/unit_test.hpp>
+
+// PMacc
+#include <Environment.hpp>
+#include <algorithms/Histogram.hpp>
+#include <memory/buffers/HostDeviceBuffer.hpp>
+#include "pmacc_types.hpp"
+
+
+/*******************************************************************************
+ * Test Suites
+ ******************************************************************************/
+typedef PMaccFixture<TEST_DIM> MyPMaccFixture;
+BOOST_GLOBAL_FIXTURE(MyPMaccFixture);
+
+BOOST_AUTO_TEST_SUITE( algorithms )
+
+  BOOST_AUTO_TEST_SUITE( Histogram )
+#   include "Histogram/privatized.hpp"
+  BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,282 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "Environment.hpp"
+#include "ppFunctions.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+
+namespace benchmark
+{
+
+/** timing state of one benchmark
+ *
+ * The measured loop is written as
+ * @code
+ * while(state.keepRunning())
+ *     work();
+ * @endcode
+ * The setup before the loop is executed only once: keepRunning() repeats
+ * the loop body in batches of growing size until one batch takes at least
+ * the minimum time, only the last batch is reported.
+ * Before the time of a batch is taken all pending PMacc tasks and
+ * CUDA operations are finished.
+ */
+class State
+{
+public:
+
+    State(double const minTime, uint64_t const maxIterations) :
+        minTime(minTime), maxIterations(maxIterations), batchSize(0), remaining(0),
+        numIterations(0), realTime(0.), itemsProcessed(0), bytesProcessed(0)
+    {
+    }
+
+    bool keepRunning()
+    {
+        if (remaining != 0)
+        {
+            --remaining;
+            return true;
+        }
+        if (batchSize == 0)
+            return startBatch(1);
+
+        synchronize();
+        double const elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (elapsed >= minTime || batchSize >= maxIterations)
+        {
+            numIterations = batchSize;
+            realTime = elapsed;
+            return false;
+        }
+        /* predict the batch size needed to reach the minimum time */
+        double factor = elapsed > 0. ? 1.4 * minTime / elapsed : 10.;
+        factor = std::min(std::max(factor, 2.), 10.);
+        return startBatch(std::min(maxIterations, static_cast<uint64_t>(double(batchSize) * factor)));
+    }
+
+    /** number of iterations of the reported batch, valid after the loop */
+    uint64_t iterations() const
+    {
+        return numIterations;
+    }
+
+    /** wall clock time of the reported batch in seconds, valid after the loop */
+    double getRealTime() const
+    {
+        return realTime;
+    }
+
+    /** set the number of processed items of all reported iterations */
+    void setItemsProcessed(uint64_t const items)
+    {
+        itemsProcessed = items;
+    }
+
+    /** set the number of processed bytes of all reported iterations */
+    void setBytesProcessed(uint64_t const bytes)
+    {
+        bytesProcessed = bytes;
+    }
+
+    uint64_t getItemsProcessed() const
+    {
+        return itemsProcessed;
+    }
+
+    uint64_t getBytesProcessed() const
+    {
+        return bytesProcessed;
+    }
+
+private:
+
+    typedef std::chrono::steady_clock Clock;
+
+    bool startBatch(uint64_t const size)
+    {
+        synchronize();
+        batchSize = size;
+        remaining = size - 1;
+        start = Clock::now();
+        return true;
+    }
+
+    static void synchronize()
+    {
+        PMacc::Environment<>::get().Manager().waitForAllTasks();
+        CUDA_CHECK(cudaDeviceSynchronize());
+    }
+
+    double const minTime;
+    uint64_t const maxIterations;
+    uint64_t batchSize;
+    uint64_t remaining;
+    uint64_t numIterations;
+    double realTime;
+    uint64_t itemsProcessed;
+    uint64_t bytesProcessed;
+    Clock::time_point start;
+};
+
+/** result of one benchmark */
+struct Result
+{
+    std::string name;
+    uint64_t iterations;
+    /* time per iteration in nanoseconds */
+    double realTime;
+    double itemsPerSecond;
+    double bytesPerSecond;
+};
+
+/** list of all registered benchmarks */
+class Registry
+{
+public:
+
+    typedef void (*Function)(State&);
+
+    struct Entry
+    {
+        std::string name;
+        Function function;
+    };
+
+    static Registry& getInstance()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    int add(std::string const & name, Function function)
+    {
+        Entry entry = {name, function};
+        entries.push_back(entry);
+        return 0;
+    }
+
+    /** run all benchmarks whose name contains filter
+     *
+     * @param filter sub string of the benchmark name, empty selects all
+     * @param minTime minimum time of the reported batch in seconds
+     * @return results in registration order
+     */
+    std::vector<Result> run(std::string const & filter, double const minTime) const
+    {
+        std::vector<Result> results;
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            if (entries[i].name.find(filter) == std::string::npos)
+                continue;
+            State state(minTime, 1000000000llu);
+            entries[i].function(state);
+
+            Result result;
+            result.name = entries[i].name;
+            result.iterations = state.iterations();
+            double const seconds = state.getRealTime();
+            result.realTime = result.iterations == 0 ? 0. : seconds * 1.e9 / double(result.iterations);
+            result.itemsPerSecond = seconds > 0. ? double(state.getItemsProcessed()) / seconds : 0.;
+            result.bytesPerSecond = seconds > 0. ? double(state.getBytesProcessed()) / seconds : 0.;
+            results.push_back(result);
+
+            std::cout << std::left << std::setw(40) << result.name << std::right
+                << std::setw(14) << std::fixed << std::setprecision(1) << result.realTime << " ns"
+                << std::setw(14) << result.iterations;
+            if (result.itemsPerSecond > 0.)
+                std::cout << std::setw(12) << std::setprecision(3) << result.itemsPerSecond * 1.e-6 << " Mitems/s";
+            if (result.bytesPerSecond > 0.)
+                std::cout << std::setw(12) << std::setprecision(3) << result.bytesPerSecond / (1024. * 1024. * 1024.) << " GiB/s";
+            std::cout << std::endl;
+        }
+        return results;
+    }
+
+private:
+
+    Registry()
+    {
+    }
+
+    std::vector<Entry> entries;
+};
+
+/** write results with the keys of the Google Benchmark JSON format
+ *
+ * Files can be compared with `compare.py` from Google Benchmark.
+ */
+inline void writeJson(std::string const & fileName, std::vector<Result> const & results)
+{
+    std::ofstream file(fileName.c_str());
+    if (!file)
+        throw std::runtime_error(std::string("benchmark: can not open file ") + fileName);
+
+    file << "{" << std::endl;
+    file << "  \"context\": {\"library\": \"libPMacc\"}," << std::endl;
+    file << "  \"benchmarks\": [" << std::endl;
+    file << std::setprecision(10);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        Result const & r = results[i];
+        file << "    {\"name\": \"" << r.name << "\""
+            << ", \"iterations\": " << r.iterations
+            << ", \"real_time\": " << r.realTime
+            << ", \"cpu_time\": " << r.realTime
+            << ", \"time_unit\": \"ns\"";
+        if (r.itemsPerSecond > 0.)
+            file << ", \"items_per_second\": " << r.itemsPerSecond;
+        if (r.bytesPerSecond > 0.)
+            file << ", \"bytes_per_second\": " << r.bytesPerSecond;
+        file << "}";
+        if (i + 1 != results.size())
+            file << ",";
+        file << std::endl;
+    }
+    file << "  ]" << std::endl;
+    file << "}" << std::endl;
+}
+
+} //namespace benchmark
+
+/** define and register a benchmark
+ *
+ * @param name name of the benchmark (unique identifier)
+ *
+ * The macro must be followed by the body of `void name(benchmark::State& state)`.
+ */
+#define PMACC_BENCHMARK(name)                                                  \
+    static void name(::benchmark::State& state);                               \
+    static int const PMACC_JOIN(pmaccBenchmark_, name) =                       \
+        ::benchmark::Registry::getInstance().add(#name, &name);                \
+    static void name(::benchmark::State& state)
@@ -0,0 +1,65 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Benchmark.hpp"
+#include "Grid.hpp"
+
+#include "memory/buffers/DeviceBufferIntern.hpp"
+
+namespace benchmark
+{
+
+/* guard exchange with all 26 neighbors, each exchange waits for the previous one */
+PMACC_BENCHMARK(GridBuffer_exchange)
+{
+    Grid grid;
+    grid.addExchanges();
+
+    uint64_t bytesPerExchange = 0;
+    for (uint32_t i = 1; i < PMacc::traits::NumberOfExchanges<DIM3>::value; ++i)
+        bytesPerExchange += grid.src.getSendExchange(i).getDeviceBuffer().getDataSpace().productOfComponents() *
+            sizeof(float);
+
+    while (state.keepRunning())
+    {
+        __setTransactionEvent(grid.src.asyncCommunication(__getTransactionEvent()));
+    }
+    state.setItemsProcessed(state.iterations());
+    state.setBytesProcessed(state.iterations() * bytesPerExchange);
+}
+
+/* overhead of the event system for small, dependent device tasks */
+PMACC_BENCHMARK(EventSystem_taskThroughput)
+{
+    PMacc::DeviceBufferIntern<float, DIM1> buffer(PMacc::DataSpace<DIM1>(32));
+    const uint32_t tasksPerIteration = 100;
+
+    while (state.keepRunning())
+    {
+        for (uint32_t i = 0; i < tasksPerIteration; ++i)
+            buffer.setValue(float(i));
+    }
+    state.setItemsProcessed(state.iterations() * tasksPerIteration);
+}
+
+} //namespace benchmark
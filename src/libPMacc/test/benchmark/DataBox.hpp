@@ -0,0 +1,145 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Benchmark.hpp"
+#include "Grid.hpp"
+
+#include "memory/buffers/HostBufferIntern.hpp"
+#include "memory/boxes/CachedBox.hpp"
+#include "mappings/kernel/AreaMapping.hpp"
+#include "mappings/threads/ThreadCollective.hpp"
+#include "nvidia/functors/Assign.hpp"
+
+namespace benchmark
+{
+namespace kernel
+{
+    using namespace PMacc;
+
+    struct Copy
+    {
+        template<class T_BoxSrc, class T_BoxDst, class T_Mapping>
+        DINLINE void operator()(T_BoxSrc src, T_BoxDst dst, T_Mapping mapper) const
+        {
+            const Space block(mapper.getSuperCellIndex(Space(blockIdx)));
+            const Space cell(block * T_Mapping::SuperCellSize::toRT() + Space(threadIdx));
+            dst(cell) = src(cell);
+        }
+    };
+
+    /** seven point Laplace stencil on a shared memory cache */
+    struct Laplace
+    {
+        template<class T_BoxSrc, class T_BoxDst, class T_Mapping>
+        DINLINE void operator()(T_BoxSrc src, T_BoxDst dst, T_Mapping mapper) const
+        {
+            typedef typename T_BoxSrc::ValueType Type;
+            typedef SuperCellDescription<
+                typename T_Mapping::SuperCellSize,
+                math::CT::Int<1, 1, 1>,
+                math::CT::Int<1, 1, 1>
+            > BlockArea;
+            auto cache = CachedBox::create<0, Type>(BlockArea());
+
+            const Space block(mapper.getSuperCellIndex(Space(blockIdx)));
+            const Space blockCell(block * T_Mapping::SuperCellSize::toRT());
+            const Space threadIndex(threadIdx);
+
+            ThreadCollective<BlockArea> collective(threadIndex);
+            nvidia::functors::Assign assign;
+            collective(assign, cache, src.shift(blockCell));
+            __syncthreads();
+
+            Type result = Type(-6.0) * cache(threadIndex);
+            for (uint32_t d = 0; d < DIM3; ++d)
+            {
+                Space offset;
+                offset[d] = 1;
+                result += cache(threadIndex + offset) + cache(threadIndex - offset);
+            }
+            dst(blockCell + threadIndex) = result;
+        }
+    };
+
+} //namespace kernel
+
+/* sum over a host buffer, measures the index arithmetic of DataBox */
+PMACC_BENCHMARK(DataBox_hostSum)
+{
+    const Space size(128, 128, 128);
+    PMacc::HostBufferIntern<float, DIM3> buffer(size);
+    buffer.setValue(1.0f);
+    auto box = buffer.getDataBox();
+
+    float sum = 0.0f;
+    while (state.keepRunning())
+    {
+        for (int z = 0; z < size.z(); ++z)
+            for (int y = 0; y < size.y(); ++y)
+                for (int x = 0; x < size.x(); ++x)
+                    sum += box(Space(x, y, z));
+    }
+    /* keep the result alive */
+    if (sum < 0.0f)
+        std::cout << sum << std::endl;
+
+    state.setItemsProcessed(state.iterations() * size.productOfComponents());
+    state.setBytesProcessed(state.iterations() * size.productOfComponents() * sizeof(float));
+}
+
+/* device to device copy of core and border with one cell per thread */
+PMACC_BENCHMARK(DataBox_deviceCopy)
+{
+    Grid grid;
+    PMacc::AreaMapping<PMacc::CORE + PMacc::BORDER, MappingDesc> mapper(grid.mapping);
+
+    while (state.keepRunning())
+    {
+        PMACC_KERNEL(kernel::Copy{})
+            (mapper.getGridDim(), SuperCellSize::toRT())
+            (grid.src.getDeviceBuffer().getDataBox(),
+             grid.dst.getDeviceBuffer().getDataBox(),
+             mapper);
+    }
+    state.setItemsProcessed(state.iterations() * grid.getNumCells());
+    state.setBytesProcessed(state.iterations() * grid.getNumCells() * 2u * sizeof(float));
+}
+
+/* stencil with CachedBox and ThreadCollective, including the guard load */
+PMACC_BENCHMARK(CachedBox_laplace)
+{
+    Grid grid;
+    PMacc::AreaMapping<PMacc::CORE + PMacc::BORDER, MappingDesc> mapper(grid.mapping);
+
+    while (state.keepRunning())
+    {
+        PMACC_KERNEL(kernel::Laplace{})
+            (mapper.getGridDim(), SuperCellSize::toRT())
+            (grid.src.getDeviceBuffer().getDataBox(),
+             grid.dst.getDeviceBuffer().getDataBox(),
+             mapper);
+    }
+    state.setItemsProcessed(state.iterations() * grid.getNumCells());
+}
+
+} //namespace benchmark
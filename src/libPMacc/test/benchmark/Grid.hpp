@@ -0,0 +1,83 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "Environment.hpp"
+#include "dimensions/DataSpace.hpp"
+#include "dimensions/GridLayout.hpp"
+#include "mappings/kernel/MappingDescription.hpp"
+#include "memory/buffers/GridBuffer.hpp"
+#include "memory/dataTypes/Mask.hpp"
+#include "traits/NumberOfExchanges.hpp"
+#include "math/Vector.hpp"
+
+namespace benchmark
+{
+    typedef PMacc::DataSpace<DIM3> Space;
+    typedef PMacc::math::CT::Int<8, 8, 4> SuperCellSize;
+    typedef PMacc::MappingDescription<DIM3, SuperCellSize> MappingDesc;
+    typedef PMacc::GridBuffer<float, DIM3> FieldBuffer;
+
+    /** communication tags of the benchmark buffers */
+    enum CommunicationTags
+    {
+        FIELD_TAG = 0u
+    };
+
+    /** local field with one guard super cell in each direction
+     *
+     * The size of the local domain is taken from the SubGrid.
+     */
+    struct Grid
+    {
+        Grid() :
+            layout(PMacc::Environment<DIM3>::get().SubGrid().getLocalDomain().size,
+                   SuperCellSize::toRT()),
+            mapping(layout.getDataSpace(), 1, 1),
+            src(layout, false),
+            dst(layout, false)
+        {
+            src.getDeviceBuffer().setValue(1.0f);
+            dst.getDeviceBuffer().setValue(0.0f);
+        }
+
+        /** add exchanges to all 26 neighbors to the source buffer */
+        void addExchanges()
+        {
+            for (uint32_t i = 1; i < PMacc::traits::NumberOfExchanges<DIM3>::value; ++i)
+                src.addExchange(PMacc::GUARD, PMacc::Mask(i), Space::create(1), FIELD_TAG);
+        }
+
+        /** number of cells in core and border */
+        uint64_t getNumCells() const
+        {
+            return layout.getDataSpaceWithoutGuarding().productOfComponents();
+        }
+
+        PMacc::GridLayout<DIM3> layout;
+        MappingDesc mapping;
+        FieldBuffer src;
+        FieldBuffer dst;
+    };
+
+} //namespace benchmark
@@ -0,0 +1,122 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Benchmark.hpp"
+
+#include "math/Vector.hpp"
+#include "algorithms/math.hpp"
+#include "memory/buffers/DeviceBufferIntern.hpp"
+#include "dataManagement/ISimulationData.hpp"
+#include "random/RNGProvider.hpp"
+#include "random/distributions/Uniform.hpp"
+#include "random/methods/Xor.hpp"
+#include "random/methods/MRG32k3aMin.hpp"
+
+#include <memory>
+
+namespace benchmark
+{
+namespace kernel
+{
+    using namespace PMacc;
+
+    /** draw numbers per thread and store the sum to keep the work alive */
+    struct DrawRandom
+    {
+        template<class T_Box, class T_Random>
+        DINLINE void operator()(T_Box box, T_Random rand, uint32_t numSamples) const
+        {
+            const DataSpace<DIM1> idx(blockIdx.x * blockDim.x + threadIdx.x);
+            rand.init(idx);
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < numSamples; ++i)
+                sum += rand();
+            box(idx) = sum;
+        }
+    };
+
+} //namespace kernel
+
+/* cross and dot product of host vectors */
+PMACC_BENCHMARK(Vector_crossDot)
+{
+    typedef PMacc::math::Vector<float, DIM3> Float3;
+    const size_t numVectors = 1024 * 1024;
+    std::vector<Float3> a(numVectors, Float3(1.0f, 2.0f, 3.0f));
+    std::vector<Float3> b(numVectors, Float3(3.0f, 2.0f, 1.0f));
+
+    float sum = 0.0f;
+    while (state.keepRunning())
+    {
+        for (size_t i = 0; i < numVectors; ++i)
+        {
+            const Float3 c = PMacc::algorithms::math::cross(a[i], b[i]);
+            sum += PMacc::algorithms::math::dot(c, a[i]);
+        }
+    }
+    /* keep the result alive */
+    if (sum != 0.0f)
+        std::cout << sum << std::endl;
+
+    state.setItemsProcessed(state.iterations() * numVectors);
+}
+
+template<class T_Method>
+void drawRandom(State& state)
+{
+    typedef PMacc::random::RNGProvider<DIM1, T_Method> RNGProvider;
+    typedef PMacc::random::distributions::Uniform<float> Distribution;
+
+    const uint32_t blockSize = 256;
+    const uint32_t numThreads = 256 * blockSize;
+    const uint32_t numSamples = 64;
+
+    PMacc::DeviceBufferIntern<float, DIM1> buffer(PMacc::DataSpace<DIM1>(numThreads));
+    auto provider = new RNGProvider(PMacc::DataSpace<DIM1>(numThreads));
+    provider->init(42);
+    const PMacc::SimulationDataId id = provider->getUniqueId();
+    PMacc::Environment<>::get().DataConnector().share(std::shared_ptr<PMacc::ISimulationData>(provider));
+
+    auto rand = RNGProvider::template createRandom<Distribution>();
+    while (state.keepRunning())
+    {
+        PMACC_KERNEL(kernel::DrawRandom{})
+            (numThreads / blockSize, blockSize)
+            (buffer.getDataBox(), rand, numSamples);
+    }
+    PMacc::Environment<>::get().DataConnector().unshare(id);
+    state.setItemsProcessed(state.iterations() * numThreads * numSamples);
+}
+
+/* random number generation on the device */
+PMACC_BENCHMARK(Random_xor)
+{
+    drawRandom<PMacc::random::methods::Xor>(state);
+}
+
+PMACC_BENCHMARK(Random_mrg32k3aMin)
+{
+    drawRandom<PMacc::random::methods::MRG32k3aMin>(state);
+}
+
+} //namespace benchmark
@@ -0,0 +1,84 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** micro benchmarks of the libPMacc building blocks
+ *
+ * usage: mpiexec -n <ranks> PMaccBenchmarks [options]
+ *   --devices <n>       number of ranks, must match the MPI size (default: 1)
+ *   --filter <string>   run only benchmarks whose name contains string
+ *   --min-time <sec>    minimum time of the measured batch (default: 0.5)
+ *   --json <file>       write the results in the Google Benchmark JSON format
+ *
+ * The ranks are distributed along x, each rank uses a local domain
+ * of 128x128x128 cells.
+ */
+
+#include "Benchmark.hpp"
+#include "DataBox.hpp"
+#include "Communication.hpp"
+#include "Math.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string jsonFile;
+    double minTime = 0.5;
+    int numRanks = 1;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--devices") == 0)
+            numRanks = std::atoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--filter") == 0)
+            filter = argv[i + 1];
+        else if (std::strcmp(argv[i], "--min-time") == 0)
+            minTime = std::atof(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--json") == 0)
+            jsonFile = argv[i + 1];
+        else
+        {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    const benchmark::Space devices(numRanks, 1, 1);
+    const benchmark::Space periodic = benchmark::Space::create(1);
+    const benchmark::Space localSize(128, 128, 128);
+    PMacc::Environment<DIM3>::get().initDevices(devices, periodic);
+    PMacc::GridController<DIM3>& gc = PMacc::Environment<DIM3>::get().GridController();
+    PMacc::Environment<DIM3>::get().initGrids(localSize * devices, localSize, gc.getPosition() * localSize);
+
+    const bool isMaster = gc.getGlobalRank() == 0;
+    if (!isMaster)
+        std::cout.setstate(std::ios_base::failbit);
+
+    std::vector<benchmark::Result> results =
+        benchmark::Registry::getInstance().run(filter, minTime);
+    if (isMaster && !jsonFile.empty())
+        benchmark::writeJson(jsonFile, results);
+
+    std::cout.clear();
+    PMacc::Environment<>::get().finalize();
+    return 0;
+}
@@ -0,0 +1,92 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/* #includes in "test/mpiUT.cu" */
+
+/**
+ * Checks that a non-blocking reduction delivers the same result as the
+ * blocking reduction and calls the callback on all ranks exactly once.
+ * Each rank contributes rank + 1, the test is independent of the number
+ * of ranks.
+ */
+template<class T_ReduceMethod>
+void asyncReduceTest(bool const waitForEvent)
+{
+    constexpr size_t numValues = 3;
+
+    int rank = 0;
+    int numRanks = 1;
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numRanks));
+
+    ::PMacc::mpi::MPIReduce reduce;
+    T_ReduceMethod const method = T_ReduceMethod();
+
+    std::vector<double> src(numValues);
+    for(size_t i = 0; i < numValues; ++i)
+        src[i] = double((rank + 1) * (i + 1));
+
+    std::vector<double> blockingResult(numValues, 0.0);
+    reduce(::PMacc::nvidia::functors::Add(), &blockingResult[0], &src[0], numValues, method);
+
+    int numCalls = 0;
+    std::vector<double> asyncResult;
+    ::PMacc::EventTask event = reduce.async(
+        ::PMacc::nvidia::functors::Add(),
+        &src[0],
+        numValues,
+        method,
+        [&numCalls, &asyncResult](double const * result)
+        {
+            ++numCalls;
+            if(result != nullptr)
+                asyncResult.assign(result, result + numValues);
+        }
+    );
+    /* the input is copied by async() */
+    src.assign(numValues, -1.0);
+
+    if(waitForEvent)
+        event.waitForFinished();
+    else
+        ::PMacc::Environment<>::get().Manager().waitForAllTasks();
+
+    BOOST_REQUIRE_EQUAL( numCalls, 1 );
+    BOOST_REQUIRE_EQUAL( asyncResult.empty(), !reduce.hasResult(method) );
+    if(reduce.hasResult(method))
+    {
+        double const sumRanks = double(numRanks * (numRanks + 1) / 2);
+        for(size_t i = 0; i < numValues; ++i)
+        {
+            BOOST_CHECK_EQUAL( asyncResult[i], sumRanks * double(i + 1) );
+            BOOST_CHECK_EQUAL( asyncResult[i], blockingResult[i] );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( async )
+{
+    asyncReduceTest< ::PMacc::mpi::reduceMethods::Reduce >( true );
+    asyncReduceTest< ::PMacc::mpi::reduceMethods::Reduce >( false );
+    asyncReduceTest< ::PMacc::mpi::reduceMethods::AllReduce >( true );
+}
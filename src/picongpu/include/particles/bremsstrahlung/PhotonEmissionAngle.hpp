@@ -116,7 +116,10 @@ struct GetPhotonAngle
 private:
 
     typedef boost::shared_ptr<PMacc::container::DeviceBuffer<float_X, DIM2> > MyBuf;
+    typedef boost::shared_ptr<PMacc::container::HostBuffer<float_X, DIM2> > MyHostBuf;
     MyBuf dBufTheta;
+    /* host table, only valid until uploadTable() */
+    MyHostBuf hBufTheta;
 
     /** probability density at polar angle theta.
      * It's the ultrarelativistic limit of the dipole radiation formula, see e.g. Jackson, chap. 15.2
@@ -220,17 +223,36 @@ private:
 public:
 
     /** Generate lookup table
+     *
+     * Equal to prepareTable(), computeTable() and uploadTable().
      */
     void init()
+    {
+        this->prepareTable();
+        this->computeTable();
+        this->uploadTable();
+    }
+
+    /** Allocate the device and host lookup table
+     */
+    void prepareTable()
     {
         // there is a margin of one cell to make the linear interpolation valid for border cells.
         this->dBufTheta = MyBuf(new PMacc::container::DeviceBuffer<float_X, DIM2>(
             photon::NUM_SAMPLES_DELTA + 1,
             photon::NUM_SAMPLES_GAMMA + 1));
 
-        PMacc::container::HostBuffer<float_X, DIM2> hBufTheta(this->dBufTheta->size());
-        hBufTheta.assign(float_X(0.0));
-        auto curTheta = hBufTheta.origin();
+        this->hBufTheta = MyHostBuf(new PMacc::container::HostBuffer<float_X, DIM2>(this->dBufTheta->size()));
+    }
+
+    /** Fill the host lookup table
+     *
+     * Does not use CUDA, can be executed concurrently on an other host thread.
+     */
+    void computeTable()
+    {
+        this->hBufTheta->assign(float_X(0.0));
+        auto curTheta = this->hBufTheta->origin();
 
         const float_64 lnMinGamma = math::log(photon::MIN_GAMMA);
         const float_64 lnMaxGamma = math::log(photon::MAX_GAMMA);
@@ -251,7 +273,14 @@ public:
             }
         }
 
-        *this->dBufTheta = hBufTheta;
+    }
+
+    /** Copy the host lookup table to the device and release it
+     */
+    void uploadTable()
+    {
+        *this->dBufTheta = *this->hBufTheta;
+        this->hBufTheta.reset();
     }
 
     /** Return a functor mapping `delta` to the photon emission polar angle `theta`,
@@ -21,6 +21,7 @@
 
 #include "particles/traits/GetAtomicNumbers.hpp"
 
+#include "cuSTL/container/HostBuffer.hpp"
 #include "cuSTL/cursor/Cursor.hpp"
 #include "cuSTL/cursor/navigator/PlusNavigator.hpp"
 #include "cuSTL/cursor/tools/LinearInterp.hpp"
@@ -99,8 +100,14 @@ public:
 private:
 
     typedef boost::shared_ptr<PMacc::container::DeviceBuffer<float_X, DIM2> > MyBuf;
+    typedef boost::shared_ptr<PMacc::container::HostBuffer<float_X, DIM2> > MyHostBuf;
     MyBuf dBufScaledSpectrum;
     MyBuf dBufStoppingPower;
+    /* host tables, only valid until uploadTables() */
+    MyHostBuf hBufScaledSpectrum;
+    MyHostBuf hBufStoppingPower;
+    /* atomic number of the target material */
+    float_64 targetZ;
 
     /** differential cross section: cross section per unit energy
      *
@@ -140,6 +147,21 @@ public:
      */
     void init(const float_64 targetZ);
 
+    /** Allocate the device and host lookup tables
+     *
+     * @param targetZ atomic number of the target material
+     */
+    void prepareTables(const float_64 targetZ);
+
+    /** Fill the host lookup tables
+     *
+     * Does not use CUDA, can be executed concurrently on an other host thread.
+     */
+    void computeTables();
+
+    /** Copy the host lookup tables to the device and release them */
+    void uploadTables();
+
     /** Return a functor representing the scaled differential cross section
      *
      * scaled differential cross section = electron energy loss times cross section per unit energy
@@ -157,7 +179,8 @@ public:
 /** Creates a `ScaledSpectrum` instance for a given electron species
  * and stores it in a map<atomic number, ScaledSpectrum> object.
  *
- * This functor is called from MySimulation::init() to generate lookup tables.
+ * This functor is called from MySimulation::init() to allocate the lookup tables,
+ * they are filled with ScaledSpectrum::computeTables() and ScaledSpectrum::uploadTables().
  */
 template<typename T_ElectronSpecies>
 struct FillScaledSpectrumMap
@@ -178,7 +201,7 @@ struct FillScaledSpectrumMap
         if(map.count(targetZ) == 0)
         {
             ScaledSpectrum scaledSpectrum;
-            scaledSpectrum.init(static_cast<float_64>(targetZ));
+            scaledSpectrum.prepareTables(static_cast<float_64>(targetZ));
             map[targetZ] = scaledSpectrum;
         }
     }
@@ -120,7 +120,15 @@ float_64 ScaledSpectrum::dcs(const float_64 Ekin, const float_64 kappa, const fl
 
 void ScaledSpectrum::init(const float_64 targetZ)
 {
-    namespace odeint = boost::numeric::odeint;
+    this->prepareTables(targetZ);
+    this->computeTables();
+    this->uploadTables();
+}
+
+
+void ScaledSpectrum::prepareTables(const float_64 targetZ)
+{
+    this->targetZ = targetZ;
 
     // there is a margin of one cell to make the linear interpolation valid for border cells.
     this->dBufScaledSpectrum = MyBuf(
@@ -132,13 +140,24 @@ void ScaledSpectrum::init(const float_64 targetZ)
             electron::NUM_SAMPLES_EKIN + 1,
             electron::NUM_SAMPLES_KAPPA + 1));
 
-    PMacc::container::HostBuffer<float_X, DIM2> hBufScaledSpectrum(this->dBufScaledSpectrum->size());
-    PMacc::container::HostBuffer<float_X, DIM2> hBufStoppingPower(this->dBufStoppingPower->size());
-    hBufScaledSpectrum.assign(float_X(0.0));
-    hBufStoppingPower.assign(float_X(0.0));
+    this->hBufScaledSpectrum = MyHostBuf(
+        new PMacc::container::HostBuffer<float_X, DIM2>(this->dBufScaledSpectrum->size()));
+    this->hBufStoppingPower = MyHostBuf(
+        new PMacc::container::HostBuffer<float_X, DIM2>(this->dBufStoppingPower->size()));
+}
+
 
-    auto curScaledSpectrum = hBufScaledSpectrum.origin();
-    auto curStoppingPower = hBufStoppingPower.origin();
+void ScaledSpectrum::computeTables()
+{
+    namespace odeint = boost::numeric::odeint;
+
+    const float_64 targetZ = this->targetZ;
+
+    this->hBufScaledSpectrum->assign(float_X(0.0));
+    this->hBufStoppingPower->assign(float_X(0.0));
+
+    auto curScaledSpectrum = this->hBufScaledSpectrum->origin();
+    auto curStoppingPower = this->hBufStoppingPower->origin();
 
     const float_64 lnEMin = math::log(electron::MIN_ENERGY);
     const float_64 lnEMax = math::log(electron::MAX_ENERGY);
@@ -190,8 +209,16 @@ void ScaledSpectrum::init(const float_64 targetZ)
         }
     }
 
-    *this->dBufScaledSpectrum = hBufScaledSpectrum;
-    *this->dBufStoppingPower = hBufStoppingPower;
+}
+
+
+void ScaledSpectrum::uploadTables()
+{
+    *this->dBufScaledSpectrum = *this->hBufScaledSpectrum;
+    *this->dBufStoppingPower = *this->hBufStoppingPower;
+
+    this->hBufScaledSpectrum.reset();
+    this->hBufStoppingPower.reset();
 }
 
 /** Return a functor representing the scaled differential cross section
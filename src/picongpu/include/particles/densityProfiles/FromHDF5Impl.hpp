@@ -25,16 +25,51 @@
 
 #include "static_assert.hpp"
 #include "memory/buffers/GridBuffer.hpp"
-#include "memory/boxes/DataBoxDim1Access.hpp"
 #include "dataManagement/DataConnector.hpp"
+#include "dimensions/DataSpaceOperations.hpp"
 
 #include <splash/splash.h>
 
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
 
 namespace picongpu
 {
 namespace densityProfiles
 {
+namespace detail
+{
+    /** number of cells per stored sample in each direction
+     *
+     * One in each direction if the parameter class does not define `cellsPerSample`.
+     */
+    template<typename T_ParamClass, typename T_Sfinae = void>
+    struct GetCellsPerSample
+    {
+        DataSpace<simDim> operator()(const T_ParamClass&) const
+        {
+            return DataSpace<simDim>::create(1);
+        }
+    };
+
+    template<typename T_ParamClass>
+    struct GetCellsPerSample<
+        T_ParamClass,
+        decltype(void(std::declval<const T_ParamClass&>().cellsPerSample[0]))
+    >
+    {
+        DataSpace<simDim> operator()(const T_ParamClass& param) const
+        {
+            DataSpace<simDim> cellsPerSample;
+            for (uint32_t d = 0; d < simDim; ++d)
+                cellsPerSample[d] = param.cellsPerSample[d];
+            return cellsPerSample;
+        }
+    };
+} // namespace detail
 
 template<typename T_ParamClass>
 struct FromHDF5Impl : public T_ParamClass
@@ -51,7 +86,7 @@ struct FromHDF5Impl : public T_ParamClass
     {
         const uint32_t numSlides = MovingWindow::getInstance( ).getSlideCounter( currentStep );
         auto window = MovingWindow::getInstance().getWindow(currentStep);
-        loadHDF5(window);
+        loadHDF5(window, currentStep);
         const SubGrid<simDim>& subGrid = Environment<simDim>::get().SubGrid();
         DataSpace<simDim> localCells = subGrid.getLocalDomain( ).size;
         totalGpuOffset = subGrid.getLocalDomain( ).offset;
@@ -70,9 +105,35 @@ struct FromHDF5Impl : public T_ParamClass
 
 private:
 
-    void loadHDF5(Window &window)
+    typedef typename FieldTmp::ValueType ValueType;
+    typedef typename ValueType::type ComponentType;
+
+    /** host copy of the loaded density including guards
+     *
+     * All species using this profile are initialized in the same step,
+     * only the first one reads the file.
+     */
+    struct Cache
+    {
+        Cache() : step(-1), isInitAfterSlide(false)
+        {
+        }
+
+        /* step of the loaded density, -1 if nothing is loaded */
+        int64_t step;
+        /* true if the density was loaded for the GPUs moved by a slide */
+        bool isInitAfterSlide;
+        std::vector<ValueType> data;
+    };
+
+    static Cache& getCache()
+    {
+        static Cache cache;
+        return cache;
+    }
+
+    void loadHDF5(Window &window, const uint32_t currentStep)
     {
-        using namespace splash;
         DataConnector &dc = Environment<>::get().DataConnector();
 
         PMACC_CASSERT_MSG(
@@ -84,16 +145,75 @@ private:
 
         deviceDataBox = fieldBuffer.getDeviceBuffer().getDataBox();
 
+        ValueType* hostPtr = fieldBuffer.getHostBuffer().getBasePointer();
+        const size_t bufferSize = fieldBuffer.getHostBuffer().getDataSpace().productOfComponents();
+
+        /* the decision is equal on all ranks which read the file */
+        const bool isInitAfterSlide = MovingWindow::getInstance().isInitAfterSlide();
+        Cache& cache = getCache();
+        if (cache.step == int64_t(currentStep) && cache.isInitAfterSlide == isInitAfterSlide &&
+            cache.data.size() == bufferSize)
+        {
+            std::copy(cache.data.begin(), cache.data.end(), hostPtr);
+        }
+        else
+        {
+            /* clear host buffer with default value */
+            fieldBuffer.getHostBuffer().setValue(ValueType(ParamClass::defaultDensity));
+
+            cache.step = -1;
+            if (!readFile(window, fieldBuffer, isInitAfterSlide))
+                return;
+
+            cache.data.assign(hostPtr, hostPtr + bufferSize);
+            cache.step = currentStep;
+            cache.isInitAfterSlide = isInitAfterSlide;
+        }
+
+        /* copy host data to the device */
+        fieldBuffer.hostToDevice();
+        __getTransactionEvent().waitForFinished();
+    }
+
+    /** read the part of the file overlapping the local domain and guards
+     *
+     * During the initialization all ranks read collectively. After a slide
+     * only the moved GPUs load data, each of them reads independently.
+     * The dataset can be stored on a coarser grid with `ParamClass::cellsPerSample`
+     * cells per sample, it is interpolated linearly between the sample centers.
+     *
+     * @param isInitAfterSlide true if only the GPUs moved by a slide call this method
+     * @return true if the host buffer was filled successfully
+     */
+    template<typename T_Buffer>
+    bool readFile(Window &window, T_Buffer& fieldBuffer, const bool isInitAfterSlide)
+    {
+        using namespace splash;
+
         GridController<simDim> &gc = Environment<simDim>::get().GridController();
         const PMacc::Selection<simDim>& localDomain = Environment<simDim>::get().SubGrid().getLocalDomain();
         const uint32_t numSlides = MovingWindow::getInstance().getSlideCounter(0);
         const uint32_t maxOpenFilesPerNode = 1;
 
-        /* get a new ParallelDomainCollector for our MPI rank only*/
+        Dimensions splashMpiPos(0, 0, 0);
+        Dimensions splashMpiSize(1, 1, 1);
+        const DataSpace<simDim> cellsPerSample = detail::GetCellsPerSample<ParamClass>()(*this);
+        bool isResampled = false;
+        for (uint32_t d = 0; d < simDim; ++d)
+        {
+            if (!isInitAfterSlide)
+            {
+                splashMpiPos[d] = gc.getPosition()[d];
+                splashMpiSize[d] = gc.getGpuNodes()[d];
+            }
+            isResampled = isResampled || cellsPerSample[d] != 1;
+        }
+
+        /* a collective read over all ranks would block after a slide */
         ParallelDomainCollector pdc(
-                                    MPI_COMM_SELF,
+                                    isInitAfterSlide ? MPI_COMM_SELF : gc.getCommunicator().getMPIComm(),
                                     gc.getCommunicator().getMPIInfo(),
-                                    Dimensions(1, 1, 1),
+                                    splashMpiSize,
                                     maxOpenFilesPerNode);
 
         try
@@ -102,138 +222,146 @@ private:
             DataCollector::FileCreationAttr attr;
             DataCollector::initFileCreationAttr(attr);
             attr.fileAccType = DataCollector::FAT_READ;
+            attr.mpiPosition = splashMpiPos;
+            attr.mpiSize = splashMpiSize;
 
             pdc.open(ParamClass::filename, attr);
 
-            /* set which part of the hdf5 file our MPI rank reads */
-            DataSpace<simDim> globalSlideOffset;
-            globalSlideOffset.y() = numSlides * localDomain.size.y();
-
-            Dimensions domainOffset(0, 0, 0);
-            for (uint32_t d = 0; d < simDim; ++d)
-                domainOffset[d] = localDomain.offset[d] + globalSlideOffset[d];
+            /* file cell of the first cell of the local domain */
+            DataSpace<simDim> domainOffset(localDomain.offset);
+            domainOffset.y() += numSlides * localDomain.size.y();
 
             if (gc.getPosition().y() == 0)
-                domainOffset[1] += window.globalDimensions.offset.y();
+                domainOffset.y() += window.globalDimensions.offset.y();
 
-            DataSpace<simDim> localDomainSize = localDomain.size;
-            Dimensions domainSize(1, 1, 1);
-            for (uint32_t d = 0; d < simDim; ++d)
-                domainSize[d] = localDomainSize[d];
-
-            /* clear host buffer with default value */
-            fieldBuffer.getHostBuffer().setValue(float1_X(ParamClass::defaultDensity));
+            const DataSpace<simDim> guards = fieldBuffer.getGridLayout().getGuard();
 
-            /* get dimensions and offsets (collective call) */
+            /* get dimensions and offsets of the dataset in samples (collective call) */
             Domain fileDomain = pdc.getGlobalDomain(ParamClass::iteration, ParamClass::datasetName);
-            Dimensions fileDomainEnd = fileDomain.getOffset() + fileDomain.getSize();
-            DataSpace<simDim> accessSpace;
-            DataSpace<simDim> accessOffset;
 
-            Dimensions fileAccessSpace(1, 1, 1);
-            Dimensions fileAccessOffset(0, 0, 0);
-
-            /* For each dimension, compute how file domain and local simulation domain overlap
-             * and which sizes and offsets are required for loading data from the file.
-             **/
+            /* cells of the local domain and guards covered by the file: [accessBegin, accessEnd)
+             * samples read for these cells: [sampleBegin, sampleBegin + sampleSize)
+             * (all in file cells respectively samples) */
+            DataSpace<simDim> accessBegin;
+            DataSpace<simDim> accessEnd;
+            DataSpace<simDim> sampleBegin;
+            DataSpace<simDim> sampleSize;
+            bool isEmpty = false;
             for (uint32_t d = 0; d < simDim; ++d)
             {
-                /* file domain in/in-after sim domain */
-                if (fileDomain.getOffset()[d] >= domainOffset[d] &&
-                    fileDomain.getOffset()[d] <= domainOffset[d] + domainSize[d])
-                {
-                    accessSpace[d] = std::min(domainOffset[d] + domainSize[d] - fileDomain.getOffset()[d],
-                                              fileDomain.getSize()[d]);
-                    fileAccessSpace[d] = accessSpace[d];
-
-                    accessOffset[d] = fileDomain.getOffset()[d] - domainOffset[d];
-                    fileAccessOffset[d] = 0;
-                    continue;
-                }
-
-                /* file domain before-in sim domain */
-                if (fileDomainEnd[d] >= domainOffset[d] &&
-                    fileDomainEnd[d] <= domainOffset[d] + domainSize[d])
-                {
-                    accessSpace[d] = fileDomainEnd[d] - domainOffset[d];
-                    fileAccessSpace[d] = accessSpace[d];
-
-                    accessOffset[d] = 0;
-                    fileAccessOffset[d] = domainOffset[d] - fileDomain.getOffset()[d];
-                    continue;
-                }
+                const int fileSampleBegin = fileDomain.getOffset()[d];
+                const int fileSampleEnd = fileSampleBegin + fileDomain.getSize()[d];
 
-                /* sim domain in file domain */
-                if (domainOffset[d] >= fileDomain.getOffset()[d] &&
-                    domainOffset[d] + domainSize[d] <= fileDomainEnd[d])
+                accessBegin[d] = std::max(domainOffset[d] - guards[d], fileSampleBegin * cellsPerSample[d]);
+                accessEnd[d] = std::min(domainOffset[d] + localDomain.size[d] + guards[d],
+                                        fileSampleEnd * cellsPerSample[d]);
+                if (accessBegin[d] >= accessEnd[d])
                 {
-                    accessSpace[d] = domainSize[d];
-                    fileAccessSpace[d] = accessSpace[d];
-
-                    accessOffset[d] = 0;
-                    fileAccessOffset[d] = domainOffset[d] - fileDomain.getOffset()[d];
+                    isEmpty = true;
                     continue;
                 }
 
-                /* file domain and sim domain do not intersect, do not load anything */
-                accessSpace[d] = 0;
-                break;
+                /* one additional sample on each side for the interpolation */
+                const int halo = cellsPerSample[d] != 1 ? 1 : 0;
+                sampleBegin[d] = std::max(accessBegin[d] / cellsPerSample[d] - halo, fileSampleBegin);
+                sampleSize[d] = std::min((accessEnd[d] - 1) / cellsPerSample[d] + 1 + halo, fileSampleEnd) -
+                    sampleBegin[d];
             }
 
-            /* allocate temporary buffer for hdf5 data */
-            typedef typename FieldTmp::ValueType::type ValueType;
-            ValueType *tmpBfr = nullptr;
-
-            size_t accessSize = accessSpace.productOfComponents();
-            if (accessSize > 0)
+            Dimensions fileAccessSpace(1, 1, 1);
+            Dimensions fileAccessOffset(0, 0, 0);
+            for (uint32_t d = 0; d < simDim; ++d)
             {
-                tmpBfr = new ValueType[accessSize];
-
-                Dimensions sizeRead(0, 0, 0);
-                pdc.read(
-                         ParamClass::iteration,
-                         fileAccessSpace,
-                         fileAccessOffset,
-                         ParamClass::datasetName,
-                         sizeRead,
-                         tmpBfr);
-
-                if (sizeRead.getScalarSize() != accessSize)
-                {
-                    __delete(tmpBfr);
-                    return;
-                }
-
-                /* get the databox of the host buffer */
-                auto dataBox = fieldBuffer.getHostBuffer().getDataBox();
-                /* get a 1D access object to the databox */
-                typedef DataBoxDim1Access< typename FieldTmp::DataBoxType > D1Box;
-                DataSpace<simDim> guards = fieldBuffer.getGridLayout().getGuard();
-                D1Box d1RAccess(dataBox.shift(guards + accessOffset), accessSpace);
-
-                /* copy from temporary buffer to fieldTmp host buffer */
-                for (int i = 0; i < accessSpace.productOfComponents(); ++i)
-                {
-                    d1RAccess[i].x() = tmpBfr[i];
-                }
-
-                __delete(tmpBfr);
+                fileAccessSpace[d] = isEmpty ? 0 : sampleSize[d];
+                fileAccessOffset[d] = isEmpty ? 0 : sampleBegin[d] - fileDomain.getOffset()[d];
             }
 
+            /* ranks without overlap take part in the collective read with zero elements */
+            std::vector<ComponentType> samples(fileAccessSpace.getScalarSize());
+            Dimensions sizeRead(0, 0, 0);
+            pdc.read(
+                     ParamClass::iteration,
+                     fileAccessSpace,
+                     fileAccessOffset,
+                     ParamClass::datasetName,
+                     sizeRead,
+                     samples.empty() ? nullptr : &(*samples.begin()));
+
             pdc.close();
 
-            /* copy host data to the device */
-            fieldBuffer.hostToDevice();
-            __getTransactionEvent().waitForFinished();
+            if (isEmpty)
+                return true;
+            if (sizeRead.getScalarSize() != samples.size())
+                return false;
+
+            /* local cell zero of the host buffer is the first cell of the local domain */
+            auto dataBox = fieldBuffer.getHostBuffer().getDataBox().shift(guards);
+            const DataSpace<simDim> accessSize(accessEnd - accessBegin);
+            const int numCells = accessSize.productOfComponents();
 
+            #pragma omp parallel for
+            for (int i = 0; i < numCells; ++i)
+            {
+                const DataSpace<simDim> fileCell(accessBegin + DataSpaceOperations<simDim>::map(accessSize, i));
+                const ComponentType value = isResampled ?
+                    interpolate(samples, sampleBegin, sampleSize, cellsPerSample, fileCell) :
+                    samples[DataSpaceOperations<simDim>::map(sampleSize, fileCell - sampleBegin)];
+                dataBox(fileCell - domainOffset).x() = value;
+            }
         }
         catch (const DCException& e)
         {
             std::cerr << e.what() << std::endl;
-            return;
+            return false;
+        }
+
+        return true;
+    }
+
+    /** linear interpolation of the samples at the center of a cell
+     *
+     * Cells outside of the outermost sample centers get the value of the
+     * closest sample.
+     *
+     * @param samples values of the samples which are read from the file
+     * @param sampleBegin index of the first read sample
+     * @param sampleSize number of read samples
+     * @param cellsPerSample number of cells per sample
+     * @param fileCell cell index in the file
+     */
+    static ComponentType interpolate(
+        const std::vector<ComponentType>& samples,
+        const DataSpace<simDim>& sampleBegin,
+        const DataSpace<simDim>& sampleSize,
+        const DataSpace<simDim>& cellsPerSample,
+        const DataSpace<simDim>& fileCell)
+    {
+        DataSpace<simDim> lower;
+        float_64 weight[simDim];
+        for (uint32_t d = 0; d < simDim; ++d)
+        {
+            float_64 pos = (float_64(fileCell[d]) + 0.5) / float_64(cellsPerSample[d]) - 0.5 - sampleBegin[d];
+            pos = std::min(std::max(pos, 0.0), float_64(sampleSize[d] - 1));
+            lower[d] = int(pos);
+            weight[d] = pos - float_64(lower[d]);
         }
 
-        return;
+        float_64 value = 0.0;
+        for (uint32_t corner = 0; corner < (1u << simDim); ++corner)
+        {
+            DataSpace<simDim> idx(lower);
+            float_64 cornerWeight = 1.0;
+            for (uint32_t d = 0; d < simDim; ++d)
+            {
+                const bool isUpper = (corner >> d) & 1u;
+                cornerWeight *= isUpper ? weight[d] : 1.0 - weight[d];
+                if (isUpper)
+                    idx[d] = std::min(idx[d] + 1, sampleSize[d] - 1);
+            }
+            if (cornerWeight != 0.0)
+                value += cornerWeight * samples[DataSpaceOperations<simDim>::map(sampleSize, idx)];
+        }
+        return ComponentType(value);
     }
 
     PMACC_ALIGN(deviceDataBox,FieldTmp::DataBoxType);
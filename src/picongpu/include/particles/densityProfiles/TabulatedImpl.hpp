@@ -0,0 +1,227 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of PIConGPU.
+ *
+ * PIConGPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * PIConGPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PIConGPU.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "simulation_defines.hpp"
+#include "simulationControl/MovingWindow.hpp"
+
+#include "memory/buffers/GridBuffer.hpp"
+#include "dimensions/DataSpaceOperations.hpp"
+
+#include <boost/mpl/apply.hpp>
+
+
+namespace picongpu
+{
+namespace densityProfiles
+{
+
+/** evaluate a profile at each sample of a table
+ *
+ * one thread per table entry (1D grid)
+ */
+struct KernelTabulateProfile
+{
+    template<typename T_Profile, typename T_TableBox>
+    DINLINE void operator()(
+        T_Profile profile,
+        T_TableBox table,
+        DataSpace<simDim> tableSize,
+        DataSpace<simDim> firstSampleCell,
+        DataSpace<simDim> sampleDistance) const
+    {
+        const uint32_t linearIdx = blockIdx.x * blockDim.x + threadIdx.x;
+        if (linearIdx >= uint32_t(tableSize.productOfComponents()))
+            return;
+
+        const DataSpace<simDim> sampleIdx(DataSpaceOperations<simDim>::map(tableSize, linearIdx));
+        table(sampleIdx) = profile(firstSampleCell + sampleIdx * sampleDistance);
+    }
+};
+
+/** tabulated version of an other density profile
+ *
+ * The wrapped profile is evaluated once per construction (initialization
+ * and each slide) on a coarse grid covering the local domain, the density
+ * of a cell is interpolated linearly between the samples.
+ * Directions where the profile is constant are sampled only once, e.g. a
+ * profile which depends only on y is stored in a 1D table.
+ * All species with the same resolved profile share the table of a step.
+ *
+ * @tparam T_Profile density profile which is tabulated, e.g. `FreeFormula`
+ * @tparam T_ParamClass parameter type with the member `cellsPerSample`
+ *         (number of cells between two samples per direction,
+ *         0 if the profile is constant in this direction, 1 for an exact table)
+ */
+template<typename T_Profile, typename T_ParamClass>
+struct TabulatedImpl : public T_ParamClass
+{
+    typedef T_ParamClass ParamClass;
+    typedef T_Profile Profile;
+
+    template<typename T_SpeciesType>
+    struct apply
+    {
+        typedef typename bmpl::apply1<Profile, T_SpeciesType>::type UserProfile;
+        typedef TabulatedImpl<UserProfile, ParamClass> type;
+    };
+
+    HINLINE TabulatedImpl(uint32_t currentStep) : profile(currentStep)
+    {
+        const uint32_t numSlides = MovingWindow::getInstance( ).getSlideCounter( currentStep );
+        const SubGrid<simDim>& subGrid = Environment<simDim>::get().SubGrid();
+        const DataSpace<simDim> localCells = subGrid.getLocalDomain( ).size;
+        DataSpace<simDim> totalGpuOffset = subGrid.getLocalDomain( ).offset;
+        totalGpuOffset.y( ) += numSlides * localCells.y( );
+
+        /* samples are aligned to the global grid, neighboring devices use
+         * the same samples at their borders */
+        for (uint32_t d = 0; d < simDim; ++d)
+        {
+            sampleDistance[d] = ParamClass::cellsPerSample[d];
+            if (sampleDistance[d] == 0)
+            {
+                firstSampleCell[d] = totalGpuOffset[d];
+                tableSize[d] = 1;
+            }
+            else
+            {
+                firstSampleCell[d] = totalGpuOffset[d] / sampleDistance[d] * sampleDistance[d];
+                const int lastCell = totalGpuOffset[d] + localCells[d] - 1;
+                /* one additional sample for the interpolation of the last cells */
+                tableSize[d] = (lastCell - firstSampleCell[d]) / sampleDistance[d] + 2;
+            }
+        }
+
+        tabulate(currentStep);
+    }
+
+    /** Calculate the normalized density
+     *
+     * @param totalCellOffset total offset including all slides [in cells]
+     */
+    HDINLINE float_X operator()(const DataSpace<simDim>& totalCellOffset)
+    {
+        const DataSpace<simDim> relativeCell(totalCellOffset - firstSampleCell);
+
+        DataSpace<simDim> lower;
+        float_X weight[simDim];
+        for (uint32_t d = 0; d < simDim; ++d)
+        {
+            if (sampleDistance[d] == 0)
+            {
+                lower[d] = 0;
+                weight[d] = float_X(0.0);
+            }
+            else
+            {
+                lower[d] = relativeCell[d] / sampleDistance[d];
+                weight[d] = float_X(relativeCell[d] - lower[d] * sampleDistance[d]) /
+                    float_X(sampleDistance[d]);
+                /* cells outside of the table are evaluated directly */
+                if (relativeCell[d] < 0 || lower[d] + 1 >= tableSize[d])
+                    return profile(totalCellOffset);
+            }
+        }
+
+        float_X value = float_X(0.0);
+        for (uint32_t corner = 0; corner < (1u << simDim); ++corner)
+        {
+            DataSpace<simDim> idx(lower);
+            float_X cornerWeight = float_X(1.0);
+            for (uint32_t d = 0; d < simDim; ++d)
+            {
+                const bool isUpper = (corner >> d) & 1u;
+                cornerWeight *= isUpper ? weight[d] : float_X(1.0) - weight[d];
+                if (isUpper)
+                    idx[d] += 1;
+            }
+            /* skip corners without weight, they can be outside of the table */
+            if (cornerWeight != float_X(0.0))
+                value += cornerWeight * deviceDataBox(idx);
+        }
+        return value;
+    }
+
+private:
+
+    typedef GridBuffer<float_X, simDim> TableBuffer;
+
+    /** device table of the last construction
+     *
+     * The buffer is kept until the end of the program to avoid a
+     * reallocation for each slide.
+     */
+    struct Cache
+    {
+        Cache() : step(-1), buffer(nullptr)
+        {
+        }
+
+        /* step of the tabulated values, -1 if nothing is tabulated */
+        int64_t step;
+        DataSpace<simDim> firstSampleCell;
+        TableBuffer* buffer;
+    };
+
+    static Cache& getCache()
+    {
+        static Cache cache;
+        return cache;
+    }
+
+    void tabulate(const uint32_t currentStep)
+    {
+        Cache& cache = getCache();
+
+        if (cache.buffer != nullptr && cache.buffer->getGridLayout().getDataSpace() != tableSize)
+        {
+            __delete(cache.buffer);
+            cache.step = -1;
+        }
+        if (cache.buffer == nullptr)
+            cache.buffer = new TableBuffer(tableSize);
+
+        deviceDataBox = cache.buffer->getDeviceBuffer().getDataBox();
+
+        if (cache.step == int64_t(currentStep) && cache.firstSampleCell == firstSampleCell)
+            return;
+
+        const int numSamples = tableSize.productOfComponents();
+        const int blockSize = 256;
+        PMACC_KERNEL( KernelTabulateProfile{} )
+            ((numSamples + blockSize - 1) / blockSize, blockSize)
+            (profile, deviceDataBox, tableSize, firstSampleCell, sampleDistance);
+        __getTransactionEvent().waitForFinished();
+
+        cache.step = currentStep;
+        cache.firstSampleCell = firstSampleCell;
+    }
+
+    typedef typename TableBuffer::DataBoxType TableBox;
+
+    PMACC_ALIGN(deviceDataBox, TableBox);
+    PMACC_ALIGN(firstSampleCell, DataSpace<simDim>);
+    PMACC_ALIGN(sampleDistance, DataSpace<simDim>);
+    PMACC_ALIGN(tableSize, DataSpace<simDim>);
+    Profile profile;
+};
+}
+}
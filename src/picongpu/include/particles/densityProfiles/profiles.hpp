@@ -26,6 +26,7 @@
 #include "particles/densityProfiles/LinearExponentialImpl.hpp"
 #include "particles/densityProfiles/GaussianCloudImpl.hpp"
 #include "particles/densityProfiles/SphereFlanksImpl.hpp"
+#include "particles/densityProfiles/TabulatedImpl.hpp"
 
 #if( ENABLE_HDF5 == 1 )
 #    include "particles/densityProfiles/FromHDF5Impl.hpp"
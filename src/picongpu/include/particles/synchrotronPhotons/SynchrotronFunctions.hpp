@@ -86,7 +86,9 @@ public:
 private:
 
     typedef boost::shared_ptr<PMacc::container::DeviceBuffer<float_X, DIM1> > MyBuf;
+    typedef boost::shared_ptr<PMacc::container::HostBuffer<float_X, DIM1> > MyHostBuf;
     MyBuf dBuf_SyncFuncs[2]; // two synchrotron functions
+    MyHostBuf hBuf_SyncFuncs[2]; // host tables, only valid until uploadTables()
 
     struct BesselK
     {
@@ -110,7 +112,24 @@ public:
         first=0, second=1
     };
 
+    /** Generate the lookup tables
+     *
+     * Equal to prepareTables(), computeTables() and uploadTables().
+     */
     void init();
+
+    /** Allocate the device and host tables */
+    void prepareTables();
+
+    /** Fill the host tables
+     *
+     * Does not use CUDA, can be executed concurrently on an other host thread.
+     */
+    void computeTables();
+
+    /** Copy the host tables to the device and release them */
+    void uploadTables();
+
     /** Return a cursor representing a synchrotron function
      *
      * @param syncFunction first or second synchrotron function
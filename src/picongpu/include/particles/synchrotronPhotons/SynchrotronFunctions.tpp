@@ -98,14 +98,26 @@ float_64 SynchrotronFunctions::F_2(const float_64 x) const
 
 
 void SynchrotronFunctions::init()
+{
+    this->prepareTables();
+    this->computeTables();
+    this->uploadTables();
+}
+
+void SynchrotronFunctions::prepareTables()
 {
     const uint32_t numSamples = SYNC_FUNCS_NUM_SAMPLES;
 
     this->dBuf_SyncFuncs[first] = MyBuf(new PMacc::container::DeviceBuffer<float_X, DIM1>(numSamples));
     this->dBuf_SyncFuncs[second] = MyBuf(new PMacc::container::DeviceBuffer<float_X, DIM1>(numSamples));
 
-    PMacc::container::HostBuffer<float_X, DIM1> hBuf_F_1(numSamples);
-    PMacc::container::HostBuffer<float_X, DIM1> hBuf_F_2(numSamples);
+    this->hBuf_SyncFuncs[first] = MyHostBuf(new PMacc::container::HostBuffer<float_X, DIM1>(numSamples));
+    this->hBuf_SyncFuncs[second] = MyHostBuf(new PMacc::container::HostBuffer<float_X, DIM1>(numSamples));
+}
+
+void SynchrotronFunctions::computeTables()
+{
+    const uint32_t numSamples = SYNC_FUNCS_NUM_SAMPLES;
 
     for(uint32_t sampleIdx = 0u; sampleIdx < numSamples; sampleIdx++)
     {
@@ -116,12 +128,18 @@ void SynchrotronFunctions::init()
          */
         const float_64 x = x_m * x_m * x_m;
 
-        hBuf_F_1.origin()[sampleIdx] = static_cast<float_X>(this->F_1(x));
-        hBuf_F_2.origin()[sampleIdx] = static_cast<float_X>(this->F_2(x));
+        this->hBuf_SyncFuncs[first]->origin()[sampleIdx] = static_cast<float_X>(this->F_1(x));
+        this->hBuf_SyncFuncs[second]->origin()[sampleIdx] = static_cast<float_X>(this->F_2(x));
     }
+}
+
+void SynchrotronFunctions::uploadTables()
+{
+    *this->dBuf_SyncFuncs[first] = *this->hBuf_SyncFuncs[first];
+    *this->dBuf_SyncFuncs[second] = *this->hBuf_SyncFuncs[second];
 
-    *this->dBuf_SyncFuncs[first] = hBuf_F_1;
-    *this->dBuf_SyncFuncs[second] = hBuf_F_2;
+    this->hBuf_SyncFuncs[first].reset();
+    this->hBuf_SyncFuncs[second].reset();
 }
 
 /** Return a cursor representing a synchrotron function
@@ -23,17 +23,7 @@
 #include "simulation_defines.hpp"
 
 #include "plugins/ISimulationPlugin.hpp"
-#include "algorithms/Gamma.hpp"
-#include "algorithms/KinEnergy.hpp"
-
-#include "mpi/reduceMethods/Reduce.hpp"
-#include "mpi/MPIReduce.hpp"
-#include "nvidia/functors/Add.hpp"
-#include "dataManagement/DataConnector.hpp"
-#include "mappings/kernel/AreaMapping.hpp"
-#include "memory/shared/Allocate.hpp"
-#include "basicOperations.hpp"
-#include "dimensions/DataSpace.hpp"
+#include "plugins/particleDiagnostics/ParticleDiagnostics.hpp"
 
 #include "common/txtFileHandling.hpp"
 
@@ -49,150 +39,19 @@ using namespace PMacc;
 
 namespace po = boost::program_options;
 
-struct KernelBinEnergyParticles
-{
-    /* sum up the energy of all particles
-     * the kinetic energy of all active particles will be calculated
-     */
-    template<class ParBox, class BinBox, class Mapping>
-    DINLINE void operator()(ParBox pb,
-                                             BinBox gBins, int numBins,
-                                             float_X minEnergy,
-                                             float_X maxEnergy,
-                                             float_X maximumSlopeToDetectorX,
-                                             float_X maximumSlopeToDetectorZ,
-                                             Mapping mapper) const
-    {
-
-        typedef typename MappingDesc::SuperCellSize Block;
-        typedef typename ParBox::FramePtr FramePtr;
-
-        PMACC_SMEM( frame, FramePtr );
-
-        PMACC_SMEM( particlesInSuperCell, lcellId_t );
-
-        const bool enableDetector = maximumSlopeToDetectorX != float_X(0.0) && maximumSlopeToDetectorZ != float_X(0.0);
-
-        /* shBins index can go from 0 to (numBins+2)-1
-         * 0 is for <minEnergy
-         * (numBins+2)-1 is for >maxEnergy
-         */
-        extern __shared__ float_X shBin[]; /* size must be numBins+2 because we have <min and >max */
-
-        int realNumBins = numBins + 2;
-
-
-
-        typedef typename Mapping::SuperCellSize SuperCellSize;
-        const int threads = PMacc::math::CT::volume<SuperCellSize>::type::value;
-
-        const DataSpace<simDim > threadIndex(threadIdx);
-        const int linearThreadIdx = DataSpaceOperations<simDim>::template map<SuperCellSize > (threadIndex);
-
-        if (linearThreadIdx == 0)
-        {
-            const DataSpace<simDim> superCellIdx(mapper.getSuperCellIndex(DataSpace<simDim > (blockIdx)));
-            frame = pb.getLastFrame(superCellIdx);
-            particlesInSuperCell = pb.getSuperCell(superCellIdx).getSizeLastFrame();
-        }
-        /* set all bins to 0 */
-        for (int i = linearThreadIdx; i < realNumBins; i += threads)
-        {
-            shBin[i] = float_X(0.);
-        }
-
-        __syncthreads();
-        if (!frame.isValid())
-          return; /* end kernel if we have no frames */
-
-        while (frame.isValid())
-        {
-            if (linearThreadIdx < particlesInSuperCell)
-            {
-                auto particle = frame[linearThreadIdx];
-                /* kinetic Energy for Particles: E^2 = p^2*c^2 + m^2*c^4
-                 *                                   = c^2 * [p^2 + m^2*c^2] */
-                const float3_X mom = particle[momentum_];
-
-                bool calcParticle = true;
-
-                if (enableDetector && mom.y() > 0.0)
-                {
-                    const float_X slopeMomX = abs(mom.x() / mom.y());
-                    const float_X slopeMomZ = abs(mom.z() / mom.y());
-                    if (slopeMomX >= maximumSlopeToDetectorX || slopeMomZ >= maximumSlopeToDetectorZ)
-                    {
-                        calcParticle = false;
-                    }
-                }
-
-                if (calcParticle)
-                {
-                    const float_X weighting = particle[weighting_];
-                    const float_X mass = attribute::getMass(weighting,particle);
-
-                    // calculate kinetic energy of the macro particle
-                    float_X localEnergy = KinEnergy<>()(mom, mass);
-
-                    localEnergy /= weighting;
-
-                    /* +1 move value from 1 to numBins+1 */
-                    int binNumber = math::floor((localEnergy - minEnergy) /
-                                          (maxEnergy - minEnergy) * (float_32) numBins) + 1;
-
-                    const int maxBin = numBins + 1;
-
-                    /* all entries larger than maxEnergy go into bin maxBin */
-                    binNumber = binNumber < maxBin ? binNumber : maxBin;
-
-                    /* all entries smaller than minEnergy go into bin zero */
-                    binNumber = binNumber > 0 ? binNumber : 0;
-
-                    /*!\todo: we can't use 64bit type on this place (NVIDIA BUG?)
-                     * COMPILER ERROR: ptxas /tmp/tmpxft_00005da6_00000000-2_main.ptx, line 4246; error   : Global state space expected for instruction 'atom'
-                     * I think this is a problem with extern shared mem and atmic (only on TESLA)
-                     * NEXT BUG: don't do uint32_t w=__float2uint_rn(weighting); and use w for atomic, this create wrong results
-                     */
-                    /* overflow for big weighting reduces in shared mem */
-                    /* atomicAdd(&(shBin[binNumber]), (uint32_t) weighting); */
-                    const float_X normedWeighting = float_X(weighting) / float_X(particles::TYPICAL_NUM_PARTICLES_PER_MACROPARTICLE);
-                    atomicAddWrapper(&(shBin[binNumber]), normedWeighting);
-                }
-            }
-            __syncthreads();
-            if (linearThreadIdx == 0)
-            {
-                frame = pb.getPreviousFrame(frame);
-                particlesInSuperCell = PMacc::math::CT::volume<Block>::type::value;
-            }
-            __syncthreads();
-        }
-
-        __syncthreads();
-        for (int i = linearThreadIdx; i < realNumBins; i += threads)
-        {
-            atomicAddWrapper(&(gBins[i]), float_64(shBin[i]));
-        }
-        __syncthreads();
-    }
-};
-
 template<class ParticlesType>
 class BinEnergyParticles : public ISimulationPlugin
 {
 private:
 
     typedef MappingDesc::SuperCellSize SuperCellSize;
-
-    GridBuffer<float_64, DIM1> *gBins;
-    MappingDesc *cellDescription;
+    /* fused reductions shared with the other particle diagnostics of the species */
+    typedef particleDiagnostics::ParticleDiagnostics<ParticlesType> Diagnostics;
 
     std::string pluginName;
     std::string pluginPrefix;
     std::string filename;
 
-    float_64 * binReduced;
-
     uint32_t notifyPeriod;
     int numBins;
     int realNumBins;
@@ -210,16 +69,12 @@ private:
     /* only rank 0 create a file */
     bool writeToFile;
 
-    mpi::MPIReduce reduce;
-
 public:
 
     BinEnergyParticles() :
     pluginName("BinEnergyParticles: calculate a energy histogram of a species"),
     pluginPrefix(ParticlesType::FrameType::getName() + std::string("_energyHistogram")),
     filename(pluginPrefix + ".dat"),
-    gBins(nullptr),
-    cellDescription(nullptr),
     notifyPeriod(0),
     writeToFile(false),
     enableDetector(false)
@@ -234,7 +89,7 @@ public:
 
     void notify(uint32_t currentStep)
     {
-        calBinEnergyParticles < CORE + BORDER > (currentStep);
+        calBinEnergyParticles(currentStep);
     }
 
     void pluginRegisterHelp(po::options_description& desc)
@@ -256,7 +111,7 @@ public:
 
     void setMappingDescription(MappingDesc *cellDescription)
     {
-        this->cellDescription = cellDescription;
+        Diagnostics::getInstance().setMappingDescription(cellDescription);
     }
 
 private:
@@ -308,15 +163,30 @@ private:
 
             realNumBins = numBins + 2;
 
-            /* create an array of float_64 on gpu und host */
-            gBins = new GridBuffer<float_64, DIM1 > (DataSpace<DIM1 > (realNumBins));
-            binReduced = new float_64[realNumBins];
-            for (int i = 0; i < realNumBins; ++i)
+            /** Assumption: distanceToDetector >> simulated Area in y-Direction
+             *          AND     simulated area in X,Z << slit  */
+            float_64 maximumSlopeToDetectorX = 0.0; /*0.0 is disabled detector*/
+            float_64 maximumSlopeToDetectorZ = 0.0; /*0.0 is disabled detector*/
+            if (enableDetector)
             {
-                binReduced[i] = 0.0;
+                maximumSlopeToDetectorX = (slitDetectorX / 2.0) / (distanceToDetector);
+                maximumSlopeToDetectorZ = (slitDetectorZ / 2.0) / (distanceToDetector);
             }
 
-            writeToFile = reduce.hasResult(mpi::reduceMethods::Reduce());
+            /* convert energy values from keV to PIConGPU units */
+            const float_X minEnergy = minEnergy_keV * UNITCONV_keV_to_Joule / UNIT_ENERGY;
+            const float_X maxEnergy = maxEnergy_keV * UNITCONV_keV_to_Joule / UNIT_ENERGY;
+
+            Diagnostics::getInstance().addUser(particleDiagnostics::HISTOGRAM, notifyPeriod);
+            Diagnostics::getInstance().setHistogram(
+                numBins,
+                minEnergy,
+                maxEnergy,
+                maximumSlopeToDetectorX,
+                maximumSlopeToDetectorZ
+            );
+
+            writeToFile = Diagnostics::getInstance().hasResult();
             if( writeToFile )
                 openNewFile();
 
@@ -328,6 +198,9 @@ private:
     {
         if (notifyPeriod > 0)
         {
+            /* write the result of the reduction in flight */
+            Diagnostics::getInstance().removeUser(particleDiagnostics::HISTOGRAM);
+
             if (writeToFile)
             {
                 outFile.flush();
@@ -336,9 +209,6 @@ private:
                     std::cerr << "Error on flushing file [" << filename << "]. " << std::endl;
                 outFile.close();
             }
-
-            __delete(gBins);
-            __deleteArray(binReduced);
         }
     }
 
@@ -355,55 +225,33 @@ private:
 
     void checkpoint(uint32_t currentStep, const std::string checkpointDirectory)
     {
+        if( notifyPeriod > 0 )
+            Diagnostics::getInstance().wait();
+
         if( !writeToFile )
             return;
 
-        checkpointTxtFile( outFile,
-                           filename,
-                           currentStep,
-                           checkpointDirectory );
+        this->addCheckpointFile( checkpointTxtFile( outFile,
+                                                    filename,
+                                                    currentStep,
+                                                    checkpointDirectory ) );
     }
 
-    template< uint32_t AREA>
     void calBinEnergyParticles(uint32_t currentStep)
     {
-        gBins->getDeviceBuffer().setValue(0);
-        auto block = MappingDesc::SuperCellSize::toRT();
-
-        DataConnector &dc = Environment<>::get().DataConnector();
-        auto particles = dc.get< ParticlesType >( ParticlesType::FrameType::getName(), true );
-
-        /** Assumption: distanceToDetector >> simulated Area in y-Direction
-         *          AND     simulated area in X,Z << slit  */
-        float_64 maximumSlopeToDetectorX = 0.0; /*0.0 is disabled detector*/
-        float_64 maximumSlopeToDetectorZ = 0.0; /*0.0 is disabled detector*/
-        if (enableDetector)
-        {
-            maximumSlopeToDetectorX = (slitDetectorX / 2.0) / (distanceToDetector);
-            maximumSlopeToDetectorZ = (slitDetectorZ / 2.0) / (distanceToDetector);
-            /* maximumSlopeToDetector = (radiusDetector * radiusDetector) / (distanceToDetector * distanceToDetector); */
-        }
-
-        /* convert energy values from keV to PIConGPU units */
-        const float_X minEnergy = minEnergy_keV * UNITCONV_keV_to_Joule / UNIT_ENERGY;
-        const float_X maxEnergy = maxEnergy_keV * UNITCONV_keV_to_Joule / UNIT_ENERGY;
-
-        AreaMapping<AREA, MappingDesc> mapper(*cellDescription);
-        PMACC_KERNEL(KernelBinEnergyParticles{})
-            (mapper.getGridDim(), block, (realNumBins) * sizeof (float_X))
-            (particles->getDeviceParticlesBox(),
-             gBins->getDeviceBuffer().getDataBox(), numBins, minEnergy,
-             maxEnergy, maximumSlopeToDetectorX, maximumSlopeToDetectorZ, mapper);
-
-        dc.releaseData( ParticlesType::FrameType::getName() );
-        gBins->deviceToHost();
-
-        reduce(nvidia::functors::Add(),
-               binReduced,
-               gBins->getHostBuffer().getBasePointer(),
-               realNumBins, mpi::reduceMethods::Reduce());
-
+        /* histogram summed over all GPUs, written after the reduction is finished */
+        Diagnostics::getInstance().requestResult(
+            particleDiagnostics::HISTOGRAM,
+            currentStep,
+            [this, currentStep](const float_64* binReduced)
+            {
+                this->write(currentStep, binReduced);
+            }
+        );
+    }
 
+    void write(uint32_t currentStep, const float_64* binReduced)
+    {
         if (writeToFile)
         {
             typedef std::numeric_limits< float_64 > dbl;
@@ -109,10 +109,10 @@ void ChargeConservation::checkpoint(uint32_t currentStep, const std::string chec
     if(!this->allGPU_reduce->root())
         return;
 
-    checkpointTxtFile( this->output_file,
-                       this->filename,
-                       currentStep,
-                       checkpointDirectory );
+    this->addCheckpointFile( checkpointTxtFile( this->output_file,
+                                                this->filename,
+                                                currentStep,
+                                                checkpointDirectory ) );
 }
 
 void ChargeConservation::setMappingDescription(MappingDesc* cellDescription)
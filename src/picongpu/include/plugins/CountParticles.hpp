@@ -22,17 +22,13 @@
 #include "simulation_defines.hpp"
 
 #include "simulation_classTypes.hpp"
-#include "mappings/kernel/AreaMapping.hpp"
 
 #include "plugins/ISimulationPlugin.hpp"
+#include "plugins/particleDiagnostics/ParticleDiagnostics.hpp"
 
 #include "mpi/reduceMethods/Reduce.hpp"
 #include "mpi/MPIReduce.hpp"
-#include "nvidia/functors/Add.hpp"
 #include "nvidia/functors/Max.hpp"
-#include "dataManagement/DataConnector.hpp"
-
-#include "particles/operations/CountParticles.hpp"
 
 #include "common/txtFileHandling.hpp"
 
@@ -51,8 +47,9 @@ class CountParticles : public ISimulationPlugin
 {
 private:
     typedef MappingDesc::SuperCellSize SuperCellSize;
+    /* fused reductions shared with the other particle diagnostics of the species */
+    typedef particleDiagnostics::ParticleDiagnostics<ParticlesType> Diagnostics;
 
-    MappingDesc *cellDescription;
     uint32_t notifyPeriod;
 
     std::string pluginName;
@@ -70,7 +67,6 @@ public:
     pluginName("CountParticles: count macro particles of a species"),
     pluginPrefix(ParticlesType::FrameType::getName() + std::string("_macroParticlesCount")),
     filename(pluginPrefix + ".dat"),
-    cellDescription(nullptr),
     notifyPeriod(0),
     writeToFile(false)
     {
@@ -84,7 +80,7 @@ public:
 
     void notify(uint32_t currentStep)
     {
-        countParticles < CORE + BORDER > (currentStep);
+        countParticles(currentStep);
     }
 
     void pluginRegisterHelp(po::options_description& desc)
@@ -101,7 +97,7 @@ public:
 
     void setMappingDescription(MappingDesc *cellDescription)
     {
-        this->cellDescription = cellDescription;
+        Diagnostics::getInstance().setMappingDescription(cellDescription);
     }
 
 private:
@@ -110,7 +106,8 @@ private:
     {
         if (notifyPeriod > 0)
         {
-            writeToFile = reduce.hasResult(mpi::reduceMethods::Reduce());
+            Diagnostics::getInstance().addUser(particleDiagnostics::COUNT, notifyPeriod);
+            writeToFile = Diagnostics::getInstance().hasResult();
 
             if (writeToFile)
             {
@@ -140,6 +137,7 @@ private:
                     std::cerr << "Error on flushing file [" << filename << "]. " << std::endl;
                 outFile.close();
             }
+            Diagnostics::getInstance().removeUser(particleDiagnostics::COUNT);
         }
     }
 
@@ -159,29 +157,21 @@ private:
         if( !writeToFile )
             return;
 
-        checkpointTxtFile( outFile,
-                           filename,
-                           currentStep,
-                           checkpointDirectory );
+        this->addCheckpointFile( checkpointTxtFile( outFile,
+                                                    filename,
+                                                    currentStep,
+                                                    checkpointDirectory ) );
     }
 
-    template< uint32_t AREA>
     void countParticles(uint32_t currentStep)
     {
-        uint64_cu size;
-
-        const SubGrid<simDim>& subGrid = Environment<simDim>::get().SubGrid();
-        const DataSpace<simDim> localSize(subGrid.getLocalDomain().size);
-
-        DataConnector &dc = Environment<>::get().DataConnector();
-        auto particles = dc.get< ParticlesType >( ParticlesType::FrameType::getName(), true );
-
-        /*count local particles*/
-        size = PMacc::CountParticles::countOnDevice<AREA>(*particles,
-                                                          *cellDescription,
-                                                          DataSpace<simDim>(),
-                                                          localSize);
-        dc.releaseData( ParticlesType::FrameType::getName() );
+        /* the count is accumulated as float_64, exact up to 2^53 particles */
+        const uint64_cu reducedValue = static_cast<uint64_cu>(
+            Diagnostics::getInstance().getResult(particleDiagnostics::COUNT, currentStep)[0]
+        );
+        const uint64_cu size = static_cast<uint64_cu>(
+            Diagnostics::getInstance().getLocalResult(particleDiagnostics::COUNT, currentStep)[0]
+        );
 
         uint64_cu reducedValueMax;
         if (picLog::log_level & picLog::CRITICAL::lvl)
@@ -194,13 +184,6 @@ private:
         }
 
 
-        uint64_cu reducedValue;
-        reduce(nvidia::functors::Add(),
-               &reducedValue,
-               &size,
-               1,
-               mpi::reduceMethods::Reduce());
-
         if (writeToFile)
         {
             if (picLog::log_level & picLog::CRITICAL::lvl)
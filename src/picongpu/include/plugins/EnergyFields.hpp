@@ -90,6 +90,8 @@ private:
     bool writeToFile;
 
     mpi::MPIReduce mpiReduce;
+    /* reduction in flight, the result is written when it is finished */
+    EventTask pendingReduce;
 
     nvidia::reduce::Reduce* localReduce;
 
@@ -164,6 +166,7 @@ private:
     {
         if (notifyFrequency > 0)
         {
+            pendingReduce.waitForFinished();
             if (writeToFile)
             {
                 outFile.flush();
@@ -189,13 +192,15 @@ private:
 
     void checkpoint(uint32_t currentStep, const std::string checkpointDirectory)
     {
+        pendingReduce.waitForFinished();
+
         if( !writeToFile )
             return;
 
-        checkpointTxtFile( outFile,
-                           filename,
-                           currentStep,
-                           checkpointDirectory );
+        this->addCheckpointFile( checkpointTxtFile( outFile,
+                                                    filename,
+                                                    currentStep,
+                                                    checkpointDirectory ) );
     }
 
     void getEnergyFields(uint32_t currentStep)
@@ -208,19 +213,33 @@ private:
         /* idx == 0 -> fieldB
          * idx == 1 -> fieldE
          */
-        EneVectorType globalFieldEnergy[2];
-        globalFieldEnergy[0]=EneVectorType::create(0.0);
-        globalFieldEnergy[1]=EneVectorType::create(0.0);
-
         EneVectorType localReducedFieldEnergy[2];
         localReducedFieldEnergy[0] = reduceField(fieldB);
         localReducedFieldEnergy[1] = reduceField(fieldE);
 
-        mpiReduce(nvidia::functors::Add(),
-                  &globalFieldEnergy,
-                  &localReducedFieldEnergy,
-                  2,
-                  mpi::reduceMethods::Reduce());
+        dc.releaseData( FieldE::getName() );
+        dc.releaseData( FieldB::getName() );
+
+        /* the previous result is written before a new reduction is started */
+        pendingReduce.waitForFinished();
+        pendingReduce = mpiReduce.async(
+            nvidia::functors::Add(),
+            localReducedFieldEnergy,
+            2,
+            mpi::reduceMethods::Reduce(),
+            [this, currentStep](const EneVectorType* reducedFieldEnergy)
+            {
+                if (reducedFieldEnergy != nullptr)
+                    this->write(currentStep, reducedFieldEnergy);
+            }
+        );
+    }
+
+    void write(uint32_t currentStep, const EneVectorType* reducedFieldEnergy)
+    {
+        EneVectorType globalFieldEnergy[2];
+        globalFieldEnergy[0] = reducedFieldEnergy[0];
+        globalFieldEnergy[1] = reducedFieldEnergy[1];
 
         float_64 energyFieldBReduced=0.0;
         float_64 energyFieldEReduced=0.0;
@@ -35,8 +35,18 @@
 #include "memory/shared/Allocate.hpp"
 #include "memory/Array.hpp"
 #include "dataManagement/DataConnector.hpp"
+#include "mappings/simulation/GridController.hpp"
+#include "cuSTL/container/HostBuffer.hpp"
+#include "cuSTL/algorithm/mpi/Reduce.hpp"
+#include "cuSTL/zone/SphericZone.hpp"
+#include "math/vector/Int.hpp"
+#include "math/vector/Size_t.hpp"
+#include "math/vector/math_functor/max.hpp"
+#include "lambda/Expression.hpp"
 
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -130,8 +140,17 @@ private:
 
     std::ofstream outFileMax;
     std::ofstream outFileIntegrated;
-    /*only rank 0 create a file*/
+    /*only rank 0 of commSlabRoots create a file*/
     bool writeToFile;
+
+    /** reduce all GPUs with the same y position (transversal plane) */
+    PMacc::algorithm::mpi::Reduce<simDim>* planeReduce;
+    bool isPlaneReduceRoot;
+    /** MPI communicator with the roots of all planeReduce operations,
+     *  MPI_COMM_NULL if this rank is not a root */
+    MPI_Comm commSlabRoots;
+    /** y offsets of the local domains of all slab roots, only valid on the writer */
+    std::vector<int> yOffsetsSlabRoots;
 public:
 
     /*! Calculate the max und integrated E-Field energy over laser propagation direction (in our case Y)
@@ -145,7 +164,10 @@ public:
     localIntegratedIntensity(nullptr),
     cellDescription(nullptr),
     notifyFrequency(0),
-    writeToFile(false)
+    writeToFile(false),
+    planeReduce(nullptr),
+    isPlaneReduceRoot(false),
+    commSlabRoots(MPI_COMM_NULL)
     {
         Environment<>::get().PluginConnector().registerPlugin(this);
     }
@@ -184,7 +206,7 @@ private:
     {
         if (notifyFrequency > 0)
         {
-            writeToFile = Environment<simDim>::get().GridController().getGlobalRank() == 0;
+            createCommunicators();
             int yCells = cellDescription->getGridLayout().getDataSpaceWithoutGuarding().y();
 
             localMaxIntensity = new GridBuffer<float_32, DIM1 > (DataSpace<DIM1 > (yCells)); //create one int on gpu und host
@@ -211,16 +233,98 @@ private:
             }
             __delete(localMaxIntensity);
             __delete(localIntegratedIntensity);
+            __delete(planeReduce);
+            if (commSlabRoots != MPI_COMM_NULL)
+                MPI_CHECK(MPI_Comm_free(&commSlabRoots));
+        }
+    }
+
+    /* create the reduction over the transversal plane (x and z) of each GPU
+     * and a communicator connecting the roots of all planes (y slabs)
+     *
+     * Only the roots of the planes take part in the gather, the cost of the
+     * reduction grows logarithmically with the number of GPUs per plane.
+     */
+    void createCommunicators()
+    {
+        PMacc::GridController<simDim>& gc = PMacc::Environment<simDim>::get().GridController();
+        const PMacc::math::Size_t<simDim> gpuDim = gc.getGpuNodes();
+        const PMacc::math::Int<simDim> gpuPos = gc.getPosition();
+
+        PMacc::math::Size_t<simDim> sizeTransversalPlane(gpuDim);
+        sizeTransversalPlane.y() = 1;
+
+        for (int planePos = 0; planePos < (int)gpuDim.y(); ++planePos)
+        {
+            PMacc::math::Int<simDim> longOffset(PMacc::math::Int<simDim>::create(0));
+            longOffset.y() = planePos;
+            zone::SphericZone<simDim> zoneTransversalPlane(sizeTransversalPlane, longOffset);
+
+            /* the GPU with the lowest x and z position is the root of a plane */
+            const bool isInGroup = gpuPos.y() == planePos;
+            PMacc::math::Int<simDim> inPlaneGPU(gpuPos);
+            inPlaneGPU.y() = 0;
+            const bool isGroupRoot = isInGroup && inPlaneGPU == PMacc::math::Int<simDim>::create(0);
+
+            PMacc::algorithm::mpi::Reduce<simDim>* createReduce =
+                new PMacc::algorithm::mpi::Reduce<simDim>(zoneTransversalPlane, isGroupRoot);
+            if (isInGroup)
+            {
+                planeReduce = createReduce;
+                isPlaneReduceRoot = isGroupRoot;
+            }
+            else
+                __delete(createReduce);
+        }
+
+        /* communicator of all plane roots, ordered by the global rank */
+        std::vector<int> rootRanks(gc.getGlobalSize(), -1);
+        int myRootRank = isPlaneReduceRoot ? int(gc.getGlobalRank()) : -1;
+        MPI_CHECK(MPI_Allgather(&myRootRank, 1, MPI_INT,
+                                &(rootRanks.front()), 1, MPI_INT,
+                                MPI_COMM_WORLD));
+        std::sort(rootRanks.begin(), rootRanks.end());
+        std::vector<int> ranks(std::lower_bound(rootRanks.begin(), rootRanks.end(), 0),
+                               rootRanks.end());
+
+        MPI_Group worldGroup, rootGroup;
+        MPI_CHECK(MPI_Comm_group(MPI_COMM_WORLD, &worldGroup));
+        MPI_CHECK(MPI_Group_incl(worldGroup, ranks.size(), ranks.data(), &rootGroup));
+        MPI_CHECK(MPI_Comm_create(MPI_COMM_WORLD, rootGroup, &commSlabRoots));
+        MPI_CHECK(MPI_Group_free(&rootGroup));
+        MPI_CHECK(MPI_Group_free(&worldGroup));
+
+        writeToFile = false;
+        if (commSlabRoots != MPI_COMM_NULL)
+        {
+            int slabRank = 0;
+            int numSlabs = 1;
+            MPI_CHECK(MPI_Comm_rank(commSlabRoots, &slabRank));
+            MPI_CHECK(MPI_Comm_size(commSlabRoots, &numSlabs));
+            writeToFile = slabRank == 0;
+
+            /* the domain decomposition is static, the offsets are gathered once */
+            int yOffset = Environment<simDim>::get().SubGrid().getLocalDomain().offset.y();
+            yOffsetsSlabRoots.resize(writeToFile ? numSlabs : 0);
+            MPI_CHECK(MPI_Gather(&yOffset, 1, MPI_INT,
+                                 writeToFile ? &(yOffsetsSlabRoots.front()) : nullptr, 1, MPI_INT,
+                                 0, commSlabRoots));
         }
     }
 
 private:
 
     /* reduce data from all gpus to one array
+     *
+     * The profiles are reduced over the transversal planes and gathered
+     * by the roots of the planes only.
+     *
      * @param currentStep simulation step
      */
     void combineData(uint32_t currentStep)
     {
+        using namespace lambda;
+        using namespace PMacc::math::math_functor;
 
         const DataSpace<simDim> localSize(cellDescription->getGridLayout().getDataSpaceWithoutGuarding());
         Window window(MovingWindow::getInstance().getWindow( currentStep));
@@ -230,35 +334,47 @@ private:
         const int yGlobalSize = subGrid.getGlobalDomain().size.y();
         const int yLocalSize = localSize.y();
 
-        const int gpus = Environment<simDim>::get().GridController().getGpuNodes().productOfComponents();
+        /* reduce over the transversal plane */
+        container::HostBuffer<float_32, 1> localMax(yLocalSize);
+        container::HostBuffer<float_32, 1> localIntegrated(yLocalSize);
+        std::copy(localMaxIntensity->getHostBuffer().getBasePointer(),
+                  localMaxIntensity->getHostBuffer().getBasePointer() + yLocalSize,
+                  &(*localMax.origin()));
+        std::copy(localIntegratedIntensity->getHostBuffer().getBasePointer(),
+                  localIntegratedIntensity->getHostBuffer().getBasePointer() + yLocalSize,
+                  &(*localIntegrated.origin()));
 
+        container::HostBuffer<float_32, 1> planeMax(yLocalSize);
+        container::HostBuffer<float_32, 1> planeIntegrated(yLocalSize);
+        (*planeReduce)(planeMax, localMax, _max(_1, _2));
+        (*planeReduce)(planeIntegrated, localIntegrated, _1 + _2);
+
+        if (!isPlaneReduceRoot)
+            return;
+
+        /* gather the slabs */
+        int numSlabs = 1;
+        MPI_CHECK(MPI_Comm_size(commSlabRoots, &numSlabs));
 
         /**\todo: fixme I cant work with not regular domains (use mpi_gatherv)*/
-        DataSpace<simDim> globalRootCell(subGrid.getLocalDomain().offset);
-        int yOffset = globalRootCell.y();
-        int* yOffsetsAll = new int[gpus];
-        float_32* maxAll = new float_32[yGlobalSize];
-        float_32* maxAllTmp = new float_32[yLocalSize * gpus];
-        memset(maxAll, 0, sizeof (float_32) *yGlobalSize);
-        float_32* integretedAll = new float_32[yGlobalSize];
-        float_32* integretedAllTmp = new float_32[yLocalSize * gpus];
-        memset(integretedAll, 0, sizeof (float_32) *yGlobalSize);
-
-        MPI_CHECK(MPI_Gather(&yOffset, 1, MPI_INT, yOffsetsAll, 1,
-                             MPI_INT, 0, MPI_COMM_WORLD));
-
-        MPI_CHECK(MPI_Gather(localMaxIntensity->getHostBuffer().getBasePointer(), yLocalSize, MPI_FLOAT,
-                             maxAllTmp, yLocalSize, MPI_FLOAT,
-                             0, MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Gather(localIntegratedIntensity->getHostBuffer().getBasePointer(), yLocalSize, MPI_FLOAT,
-                             integretedAllTmp, yLocalSize, MPI_FLOAT,
-                             0, MPI_COMM_WORLD));
+        std::vector<float_32> maxAllTmp(writeToFile ? yLocalSize * numSlabs : 0);
+        std::vector<float_32> integretedAllTmp(writeToFile ? yLocalSize * numSlabs : 0);
+
+        MPI_CHECK(MPI_Gather(&(*planeMax.origin()), yLocalSize, MPI_FLOAT,
+                             writeToFile ? &(maxAllTmp.front()) : nullptr, yLocalSize, MPI_FLOAT,
+                             0, commSlabRoots));
+        MPI_CHECK(MPI_Gather(&(*planeIntegrated.origin()), yLocalSize, MPI_FLOAT,
+                             writeToFile ? &(integretedAllTmp.front()) : nullptr, yLocalSize, MPI_FLOAT,
+                             0, commSlabRoots));
 
         if (writeToFile)
         {
-            for (int i = 0; i < gpus; ++i)
+            std::vector<float_32> maxAll(yGlobalSize, float_32(0.0));
+            std::vector<float_32> integretedAll(yGlobalSize, float_32(0.0));
+
+            for (int i = 0; i < numSlabs; ++i)
             {
-                int gOffset = yOffsetsAll[i];
+                int gOffset = yOffsetsSlabRoots[i];
                 int tmpOff = yLocalSize*i;
                 for (int y = 0; y < yLocalSize; ++y)
                 {
@@ -270,7 +386,7 @@ private:
             const uint32_t numSlides = MovingWindow::getInstance().getSlideCounter(currentStep);
             size_t physicelYCellOffset = numSlides * yLocalSize + window.globalDimensions.offset.y();
             writeFile(currentStep,
-                      maxAll + window.globalDimensions.offset.y(),
+                      &(maxAll.front()) + window.globalDimensions.offset.y(),
                       window.globalDimensions.size.y(),
                       physicelYCellOffset,
                       outFileMax,
@@ -282,19 +398,13 @@ private:
                 unit*=UNIT_LENGTH;
 
             writeFile(currentStep,
-                      integretedAll + window.globalDimensions.offset.y(),
+                      &(integretedAll.front()) + window.globalDimensions.offset.y(),
                       window.globalDimensions.size.y(),
                       physicelYCellOffset,
                       outFileIntegrated,
                       unit
                       );
         }
-
-        __deleteArray(yOffsetsAll);
-        __deleteArray(maxAll);
-        __deleteArray(integretedAll);
-        __deleteArray(maxAllTmp);
-        __deleteArray(integretedAllTmp);
     }
 
     /* write data from array to a file
@@ -27,6 +27,7 @@
 #include "cuSTL/container/compile-time/SharedBuffer.hpp"
 #include "math/Vector.hpp"
 #include "math/VectorOperations.hpp"
+#include "algorithms/Histogram.hpp"
 #include "particles/access/Cell2Particle.hpp"
 
 #include "PhaseSpace.hpp"
@@ -51,6 +52,26 @@ namespace picongpu
         }
     };
 
+    /** Add a value to a bin of the shared memory phase space
+     *
+     * \tparam num_pbins number of bins in momentum space \see PhaseSpace.hpp
+     * \tparam Cursor cursor to the start of the phase space snippet in shared memory
+     */
+    template<uint32_t num_pbins, typename Cursor>
+    struct FunctorAddToBin
+    {
+        Cursor curDBufferOriginInBlock;
+
+        /** \param bin linear bin index `r_bin * num_pbins + p_bin` */
+        template<typename float_PS>
+        DINLINE void
+        operator()( const int bin, const float_PS value ) const
+        {
+            atomicAddWrapper( &(*curDBufferOriginInBlock( bin % num_pbins, bin / num_pbins )),
+                              value );
+        }
+    };
+
     /** Functor called for each particle
      *
      * Every particle in a frame of particles will end up here.
@@ -71,15 +92,17 @@ namespace picongpu
          *
          * \param frame current frame for this block
          * \param particleID id of the particle in the current frame
-         * \param curDBufferOriginInBlock section of the phase space, shifted to the start of the block
+         * \param addToBin functor adding to the section of the phase space of the block
+         * \param binCache bins of consecutive particles of this thread are summed here
          * \param el_p coordinate of the momentum \see PhaseSpace::axis_element \see AxisDescription
          * \param axis_p_range range of the momentum coordinate \see PhaseSpace::axis_p_range
          */
-        template<typename FramePtr, typename float_PS, typename Pitch >
+        template<typename FramePtr, typename T_AddToBin, typename float_PS >
         DINLINE void
         operator()( FramePtr frame,
                     uint16_t particleID,
-                    cursor::CT::BufferCursor<float_PS, Pitch> curDBufferOriginInBlock,
+                    const T_AddToBin& addToBin,
+                    algorithms::histogram::BinCache<float_PS>* binCache,
                     const uint32_t el_p,
                     const std::pair<float_X, float_X>& axis_p_range )
         {
@@ -109,8 +132,7 @@ namespace picongpu
                 p_bin = num_pbins - 1;
 
             /** \todo take particle shape into account */
-            atomicAddWrapper( &(*curDBufferOriginInBlock( p_bin, r_bin )),
-                              particleChargeDensity );
+            binCache->add( r_bin * num_pbins + p_bin, particleChargeDensity, addToBin );
         }
     };
 
@@ -183,15 +205,23 @@ namespace picongpu
             }
             __syncthreads();
 
+            /* particles of a thread in the same bin are summed before they
+             * are added to shared memory, e.g. for a cold beam */
+            typedef FunctorAddToBin<num_pbins, decltype(dBufferInBlock.origin())> AddToBin;
+            const AddToBin addToBin = {dBufferInBlock.origin()};
+            algorithms::histogram::BinCache<float_PS> binCache;
+
             FunctorParticle<r_dir, num_pbins, SuperCellSize> functorParticle;
             particleAccess::Cell2Particle<SuperCellSize> forEachParticleInCell;
             forEachParticleInCell( /* mandatory params */
                                    particlesBox, indexGlobal, functorParticle,
                                    /* optional params */
-                                   dBufferInBlock.origin(),
+                                   addToBin,
+                                   &binCache,
                                    p_element,
                                    axis_p_range
                                  );
+            binCache.flush( addToBin );
 
             __syncthreads();
             /* add to global dBuffer */
@@ -24,6 +24,14 @@
 // PMacc
 #include "Environment.hpp"
 #include "mappings/simulation/ResourceMonitor.hpp"
+#include "mpi/reduceMethods/Reduce.hpp"
+#include "mpi/MPIReduce.hpp"
+#include "nvidia/functors/Add.hpp"
+#include "nvidia/functors/Min.hpp"
+#include "nvidia/functors/Max.hpp"
+#include "debug/Tracer.hpp"
+#include "algorithms/ForEach.hpp"
+#include "forward.hpp"
 
 // PIConGPU
 #include "plugins/ILightweightPlugin.hpp"
@@ -43,15 +51,34 @@
 #include <sstream>   /* std::stringstream */
 #include <fstream>   /* std::filebuf */
 #include <map>       /* std::map */
+#include <vector>    /* std::vector */
+#include <cmath>     /* std::sqrt */
+#include <algorithm> /* std::max */
 
 // C LIB
 #include <stdlib.h> /* itoa */
 #include <stdint.h> /* uint32_t */
 
+// POSIX
+#include <sys/resource.h> /* getrusage */
+
 namespace picongpu
 {
     using namespace PMacc;
 
+    namespace resourceLog
+    {
+        /** append the name of a species to a vector */
+        template<typename T_Species>
+        struct GetSpeciesName
+        {
+            void operator()(std::vector<std::string>& names) const
+            {
+                names.push_back(T_Species::FrameType::getName());
+            }
+        };
+    } // namespace resourceLog
+
 
     class ResourceLog : public ILightweightPlugin
     {
@@ -65,13 +92,30 @@ namespace picongpu
         std::string outputFormat;
         std::vector<std::string> properties;
 
+        bool reduceOverRanks;
+
         std::filebuf fileBuf;
         std::map<std::string, bool> propertyMap;
 
+        /* reduce of all values over all ranks with the result on rank 0 */
+        mpi::MPIReduce reduce;
+
+        /* state of the last notification to log the difference to the current step */
+        uint32_t lastStep;
+        std::vector<uint64_t> lastSentBytes;
+        /* number of regions recorded by the Tracer until the last notification */
+        uint64_t lastNumTraced;
+        /* the warning about overwritten trace regions is printed once */
+        bool warnedTraceOverflow;
+
     public:
 
         ResourceLog() :
-                cellDescription(NULL)
+                cellDescription(NULL),
+                reduceOverRanks(false),
+                lastStep(0),
+                lastNumTraced(0),
+                warnedTraceOverflow(false)
         {
             Environment<>::get().PluginConnector().registerPlugin(this);
         }
@@ -88,6 +132,18 @@ namespace picongpu
             using boost::property_tree::ptree;
             ptree pt;
 
+            if(reduceOverRanks)
+            {
+                std::vector<std::string> names;
+                std::vector<float_64> values;
+                collectValues(currentStep, names, values, true);
+                const bool isMaster = reduceValues(currentStep, names, values, pt);
+                lastStep = currentStep;
+                if(isMaster)
+                    writeTree(pt);
+                return;
+            }
+
             if(contains(propertyMap, "rank"))
             {
                 size_t rank = static_cast<size_t>(Environment<simDim>::get().GridController().getGlobalRank());
@@ -119,6 +175,211 @@ namespace picongpu
                 pt.put("resourceLog.particleCount", std::accumulate(particleCounts.begin(), particleCounts.end(), 0));
             }
 
+            if(contains(propertyMap, "phaseTime") || contains(propertyMap, "exchangeBytes") ||
+               contains(propertyMap, "memory"))
+            {
+                std::vector<std::string> names;
+                std::vector<float_64> values;
+                collectValues(currentStep, names, values, false);
+                for(size_t i = 0; i < names.size(); ++i)
+                    pt.put(std::string("resourceLog.") + names[i], values[i]);
+            }
+            lastStep = currentStep;
+
+            writeTree(pt);
+        }
+
+        void pluginRegisterHelp(po::options_description& desc)
+        {
+            /* register command line parameters for your plugin */
+            desc.add_options()
+                    ("resourceLog.period", po::value<uint32_t>(&notifyPeriod)->default_value(0),
+                     "Enable ResourceLog plugin [for each n-th step]")
+                    ("resourceLog.prefix", po::value<std::string>(&outputFilePrefix)->default_value("resourceLog_"),
+                     "Set the filename prefix for output file if a filestream was selected")
+                    ("resourceLog.stream", po::value<std::string>(&streamType)->default_value("file"),
+                     "Output stream [stdout, stderr, file]")
+                    ("resourceLog.properties", po::value<std::vector<std::string> >(&properties)->multitoken(),
+                     "List of properties to log [rank, position, currentStep, cellCount, particleCount, "
+                     "phaseTime, exchangeBytes, memory] (phaseTime requires --trace-regions)")
+                    ("resourceLog.format", po::value<std::string>(&outputFormat)->default_value("json"),
+                     "Output format of log (pp for pretty print) [json, jsonpp, xml, xmlpp]")
+                    ("resourceLog.reduce", po::value<bool>(&reduceOverRanks)->zero_tokens(),
+                     "Log min, max, mean and standard deviation over all ranks in one record on rank 0 "
+                     "instead of one record per rank");
+        }
+
+        void setMappingDescription(MappingDesc *cellDescription)
+        {
+            this->cellDescription = cellDescription;
+        }
+
+    private:
+        uint32_t notifyPeriod;
+
+        /** collect all selected numeric properties of this rank
+         *
+         * The order and number of values is equal on all ranks.
+         *
+         * @param currentStep current simulation step
+         * @param[out] names property tree path of each value
+         * @param[out] values values of this rank
+         * @param withCounts collect the cell and particle counts
+         */
+        void collectValues(
+            uint32_t currentStep,
+            std::vector<std::string>& names,
+            std::vector<float_64>& values,
+            bool withCounts
+        )
+        {
+            if(withCounts && contains(propertyMap, "cellCount"))
+            {
+                names.push_back("cellCount");
+                values.push_back(float_64(resourceMonitor.getCellCount()));
+            }
+
+            if(withCounts && contains(propertyMap, "particleCount"))
+            {
+                std::vector<size_t> particleCounts = resourceMonitor.getParticleCounts<VectorAllSpecies>(*cellDescription);
+                std::vector<std::string> speciesNames;
+                ForEach<VectorAllSpecies, resourceLog::GetSpeciesName<bmpl::_1> > getSpeciesName;
+                getSpeciesName(forward(speciesNames));
+                for(size_t i = 0; i < particleCounts.size(); ++i)
+                {
+                    names.push_back(std::string("particleCount.") + speciesNames[i]);
+                    values.push_back(float_64(particleCounts[i]));
+                }
+            }
+
+            /* phases are only recorded if the Tracer is enabled (--trace-regions) */
+            if(contains(propertyMap, "phaseTime"))
+            {
+                /* regions recorded by SimulationHelper and MySimulation::runOneStep */
+                const char* phases[] = {
+                    "runOneStep", "movingWindowCheck", "dumpOneStep",
+                    "copyMomentumPrev1", "ionization", "synchrotronPhotons", "bremsstrahlung",
+                    "particlePush", "fieldSolverBeforeCurrent", "currentDeposition",
+                    "currentExchangeAndAddToEMF", "fieldSolverAfterCurrent"
+                };
+                /* runOneStep(s) and the regions of the category "step" are
+                 * tagged with s, movingWindowCheck and dumpOneStep run after
+                 * the step counter is incremented: since the last notification
+                 * runOneStep ran for [lastStep, currentStep), movingWindowCheck
+                 * for [lastStep + 1, currentStep + 1) and dumpOneStep finished
+                 * for [lastStep, currentStep), the current one is still open */
+                Tracer& tracer = Tracer::getInstance();
+                std::map<std::string, uint64_t> durations =
+                    tracer.getDurations("simulation", lastStep, currentStep);
+                durations["movingWindowCheck"] =
+                    tracer.getDurations("simulation", lastStep + 1, currentStep + 1)["movingWindowCheck"];
+                const std::map<std::string, uint64_t> stepDurations =
+                    tracer.getDurations("step", lastStep, currentStep);
+                durations.insert(stepDurations.begin(), stepDurations.end());
+
+                /* the ring buffer of the Tracer overwrote regions of this period */
+                const uint64_t numTraced = tracer.getNumRecorded();
+                if(numTraced - lastNumTraced > tracer.getCapacity() && !warnedTraceOverflow)
+                {
+                    std::cerr << "ResourceLog: " << (numTraced - lastNumTraced) << " regions were traced in "
+                              << (currentStep - lastStep) << " steps but --trace-regions is "
+                              << tracer.getCapacity() << ", phaseTime is incomplete. Use --trace-regions "
+                              << (numTraced - lastNumTraced) << " or more." << std::endl;
+                    warnedTraceOverflow = true;
+                }
+                lastNumTraced = numTraced;
+
+                const uint32_t numSteps = std::max(currentStep - lastStep, 1u);
+                for(size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); ++i)
+                {
+                    names.push_back(std::string("phaseTime.") + phases[i]);
+                    /* average time per step in milliseconds */
+                    values.push_back(float_64(durations[phases[i]]) * 1.0e-6 / float_64(numSteps));
+                }
+            }
+
+            if(contains(propertyMap, "exchangeBytes"))
+            {
+                const std::vector<uint64_t> sentBytes = resourceMonitor.getSentBytes();
+                if(lastSentBytes.size() != sentBytes.size())
+                    lastSentBytes.assign(sentBytes.size(), 0);
+                /* exchange 0 is not a direction */
+                for(size_t ex = 1; ex < sentBytes.size(); ++ex)
+                {
+                    names.push_back(std::string("exchangeBytes.") + ExchangeTypeNames()[ex]);
+                    values.push_back(float_64(sentBytes[ex] - lastSentBytes[ex]));
+                }
+                lastSentBytes = sentBytes;
+            }
+
+            if(contains(propertyMap, "memory"))
+            {
+                struct rusage usage;
+                getrusage(RUSAGE_SELF, &usage);
+                names.push_back("memory.hostPeak");
+                /* ru_maxrss is given in kilobytes */
+                values.push_back(float_64(usage.ru_maxrss) * 1024.0);
+
+                size_t freeGpuMem = 0;
+                size_t totalGpuMem = 0;
+                Environment<>::get().MemoryInfo().getMemoryInfo(&freeGpuMem, &totalGpuMem);
+                names.push_back("memory.deviceUsed");
+                values.push_back(float_64(totalGpuMem - freeGpuMem));
+            }
+        }
+
+        /** reduce values over all ranks and fill the property tree on rank 0
+         *
+         * @return true if the property tree is valid on this rank
+         */
+        bool reduceValues(
+            uint32_t currentStep,
+            const std::vector<std::string>& names,
+            std::vector<float_64>& values,
+            boost::property_tree::ptree& pt
+        )
+        {
+            const size_t numValues = values.size();
+            const bool isMaster = reduce.hasResult(mpi::reduceMethods::Reduce());
+            if(numValues == 0)
+                return isMaster;
+
+            /* values and squared values are summed within one reduce */
+            std::vector<float_64> sumValues(values);
+            sumValues.resize(2 * numValues);
+            for(size_t i = 0; i < numValues; ++i)
+                sumValues[numValues + i] = values[i] * values[i];
+
+            std::vector<float_64> minValues(numValues);
+            std::vector<float_64> maxValues(numValues);
+            std::vector<float_64> reducedSum(2 * numValues);
+
+            reduce(nvidia::functors::Min(), &minValues[0], &values[0], numValues, mpi::reduceMethods::Reduce());
+            reduce(nvidia::functors::Max(), &maxValues[0], &values[0], numValues, mpi::reduceMethods::Reduce());
+            reduce(nvidia::functors::Add(), &reducedSum[0], &sumValues[0], 2 * numValues, mpi::reduceMethods::Reduce());
+
+            if(!isMaster)
+                return false;
+
+            const float_64 numRanks = float_64(Environment<simDim>::get().GridController().getGlobalSize());
+            pt.put("resourceLog.currentStep", currentStep);
+            pt.put("resourceLog.numRanks", uint64_t(numRanks));
+            for(size_t i = 0; i < numValues; ++i)
+            {
+                const float_64 mean = reducedSum[i] / numRanks;
+                const float_64 variance = std::max(reducedSum[numValues + i] / numRanks - mean * mean, 0.0);
+                const std::string path = std::string("resourceLog.") + names[i];
+                pt.put(path + ".min", minValues[i]);
+                pt.put(path + ".max", maxValues[i]);
+                pt.put(path + ".mean", mean);
+                pt.put(path + ".stddev", std::sqrt(variance));
+            }
+            return true;
+        }
+
+        /** write the property tree to the selected output */
+        void writeTree(const boost::property_tree::ptree& pt)
+        {
             //
             // Write property tree to string stream
             std::stringstream ss;
@@ -164,30 +425,6 @@ namespace picongpu
             }
         }
 
-        void pluginRegisterHelp(po::options_description& desc)
-        {
-            /* register command line parameters for your plugin */
-            desc.add_options()
-                    ("resourceLog.period", po::value<uint32_t>(&notifyPeriod)->default_value(0),
-                     "Enable ResourceLog plugin [for each n-th step]")
-                    ("resourceLog.prefix", po::value<std::string>(&outputFilePrefix)->default_value("resourceLog_"),
-                     "Set the filename prefix for output file if a filestream was selected")
-                    ("resourceLog.stream", po::value<std::string>(&streamType)->default_value("file"),
-                     "Output stream [stdout, stderr, file]")
-                    ("resourceLog.properties", po::value<std::vector<std::string> >(&properties)->multitoken(),
-                     "List of properties to log [rank, position, currentStep, cellCount, particleCount]")
-                    ("resourceLog.format", po::value<std::string>(&outputFormat)->default_value("json"),
-                     "Output format of log (pp for pretty print) [json, jsonpp, xml, xmlpp]");
-        }
-
-        void setMappingDescription(MappingDesc *cellDescription)
-        {
-            this->cellDescription = cellDescription;
-        }
-
-    private:
-        uint32_t notifyPeriod;
-
         void pluginLoad() {
             if(notifyPeriod != 0) {
                 Environment<>::get().PluginConnector().setNotificationPeriod(this, notifyPeriod);
@@ -212,8 +449,15 @@ namespace picongpu
                 }
 
                 // Prepare file for output stream
-                if (streamType == "file") {
-                    size_t rank = static_cast<size_t>(Environment<simDim>::get().GridController().getGlobalRank());
+                size_t rank = static_cast<size_t>(Environment<simDim>::get().GridController().getGlobalRank());
+                if (streamType == "file" && reduceOverRanks) {
+                    // only rank 0 writes the reduced record
+                    if (rank == 0) {
+                        boost::filesystem::path resourceLogPath(outputFilePrefix + std::string("reduced"));
+                        fileBuf.open(resourceLogPath.string().c_str(), std::ios::out);
+                    }
+                }
+                else if (streamType == "file") {
                     std::stringstream ss;
                     ss << outputFilePrefix << rank;
                     boost::filesystem::path resourceLogPath(ss.str());
@@ -21,10 +21,14 @@
 #pragma once
 
 #include "cuSTL/container/DeviceBuffer.hpp"
+#include "cuSTL/container/HostBuffer.hpp"
 #include "math/vector/Float.hpp"
 #include "plugins/ILightweightPlugin.hpp"
 
+#include <boost/thread.hpp>
+
 #include <string>
+#include <memory>
 
 namespace picongpu
 {
@@ -46,7 +50,18 @@ private:
     int plane;
     float_X slicePoint;
     MappingDesc *cellDescription;
+    /* write raw binary files instead of ASCII files */
+    bool binaryOutput;
     container::DeviceBuffer<float3_64, simDim-1>* dBuffer_SI;
+    /* host copy of the local slice, reused for all steps */
+    container::HostBuffer<float3_64, simDim-1>* hBuffer_SI;
+    /* gathered slices (gather root only), one buffer is filled while
+     * the other one is written by the writer thread
+     */
+    container::HostBuffer<float3_64, simDim-1>* gatherBuffer;
+    container::HostBuffer<float3_64, simDim-1>* writeBuffer;
+    /* boost::thread is not copy able, shared to keep the plugin copy able */
+    std::shared_ptr<boost::thread> writerThread;
 
     void pluginLoad();
     void pluginUnload();
@@ -54,8 +69,28 @@ private:
     template<typename TField>
     void printSlice(const TField& field, int nAxis, float slicePoint, std::string filename);
 
+    /** wait until the last slice is written to disk */
+    void joinWriter();
+
+    /** write a gathered slice, executed by the writer thread
+     *
+     * @param buffer slice in SI units
+     * @param filename name of the output file
+     * @param binary write raw binary data instead of ASCII
+     */
+    static void writeSlice(
+        const container::HostBuffer<float3_64, simDim-1>* buffer,
+        std::string filename,
+        bool binary);
+
     friend class SliceFieldPrinterMulti<Field>;
 public:
+    SliceFieldPrinter() :
+        binaryOutput(false), dBuffer_SI(nullptr), hBuffer_SI(nullptr),
+        gatherBuffer(nullptr), writeBuffer(nullptr)
+    {
+    }
+
     void notify(uint32_t currentStep);
     std::string pluginGetName() const;
     void pluginRegisterHelp(po::options_description& desc);
@@ -38,6 +38,9 @@
 #include "lambda/Expression.hpp"
 
 #include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <stdint.h>
 
 
 namespace picongpu
@@ -73,6 +76,8 @@ void SliceFieldPrinter<Field>::pluginLoad()
           - precisionCast<size_t>(2 * BlockDim::toRT());
         this->dBuffer_SI = new container::DeviceBuffer<float3_64, simDim-1>(
                         size.shrink<simDim-1>((this->plane+1)%simDim));
+        this->hBuffer_SI = new container::HostBuffer<float3_64, simDim-1>(
+                        this->dBuffer_SI->size());
       }
     else
       {
@@ -88,7 +93,21 @@ void SliceFieldPrinter<Field>::pluginLoad()
 template<typename Field>
 void SliceFieldPrinter<Field>::pluginUnload()
 {
+    joinWriter();
     __delete(this->dBuffer_SI);
+    __delete(this->hBuffer_SI);
+    __delete(this->gatherBuffer);
+    __delete(this->writeBuffer);
+}
+
+template<typename Field>
+void SliceFieldPrinter<Field>::joinWriter()
+{
+    if(writerThread)
+    {
+        writerThread->join();
+        writerThread.reset();
+    }
 }
 
 template<typename Field>
@@ -117,7 +136,7 @@ void SliceFieldPrinter<Field>::notify(uint32_t currentStep)
                  view(BlockDim::toRT(), -BlockDim::toRT());
 
       std::ostringstream filename;
-      filename << this->fileName << "_" << currentStep << ".dat";
+      filename << this->fileName << "_" << currentStep << (this->binaryOutput ? ".bin" : ".dat");
       printSlice(field_coreBorder, this->plane, this->slicePoint, filename.str());
     }
 }
@@ -168,18 +187,61 @@ void SliceFieldPrinter<Field>::printSlice(const TField& field, int nAxis, float
 #endif
 
     /* copy selected plane from device to host */
-    container::HostBuffer<float3_64, simDim-1> hBuffer(dBuffer_SI->size());
-    hBuffer = *dBuffer_SI;
+    *hBuffer_SI = *dBuffer_SI;
 
     /* collect data from all nodes/GPUs */
     vec::Size_t<simDim> globalDomainSize = Environment<simDim>::get().SubGrid().getGlobalDomain().size;
     vec::Size_t<simDim-1> globalSliceSize = globalDomainSize.shrink<simDim-1>((nAxis+1)%simDim);
-    container::HostBuffer<float3_64, simDim-1> globalBuffer(globalSliceSize);
-    gather(globalBuffer, hBuffer, nAxis);
+    if(gather.root() && gatherBuffer == nullptr)
+    {
+        gatherBuffer = new container::HostBuffer<float3_64, simDim-1>(globalSliceSize);
+        writeBuffer = new container::HostBuffer<float3_64, simDim-1>(globalSliceSize);
+    }
+    /* non root ranks never access the destination buffer */
+    gather(gather.root() ? *gatherBuffer : *hBuffer_SI, *hBuffer_SI, nAxis);
     if(!gather.root()) return;
 
-    std::ofstream file(filename.c_str());
-    file << globalBuffer;
+    /* write the slice in the background, the next slice is gathered
+     * into the other buffer
+     */
+    joinWriter();
+    std::swap(gatherBuffer, writeBuffer);
+    writerThread.reset(new boost::thread(&SliceFieldPrinter<Field>::writeSlice,
+                                         writeBuffer, filename, binaryOutput));
+}
+
+template<typename Field>
+void SliceFieldPrinter<Field>::writeSlice(
+    const container::HostBuffer<float3_64, simDim-1>* buffer,
+    std::string filename,
+    bool binary)
+{
+    if(!binary)
+    {
+        std::ofstream file(filename.c_str());
+        file << *buffer;
+        return;
+    }
+
+    /* header: magic, version, number of dimensions, extent per dimension
+     * data: float3_64 in SI units, x is the fastest running index
+     */
+    std::ofstream file(filename.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    const char magic[8] = {'P', 'I', 'C', 'S', 'L', 'I', 'C', 'E'};
+    const uint32_t version = 1;
+    const uint32_t dim = simDim - 1;
+    file.write(magic, sizeof(magic));
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char*>(&dim), sizeof(dim));
+    for(uint32_t d = 0; d < dim; ++d)
+    {
+        const uint64_t extent = buffer->size()[d];
+        file.write(reinterpret_cast<const char*>(&extent), sizeof(extent));
+    }
+
+    /* host buffers allocated by the plugin are contiguous (no padding) */
+    file.write(reinterpret_cast<const char*>(buffer->getDataPointer()),
+               buffer->size().productOfComponents() * sizeof(float3_64));
 }
 
 } /* end namespace picongpu */
@@ -43,6 +43,7 @@ private:
     std::vector<std::string> fileName;
     std::vector<int> plane;
     std::vector<float_X> slicePoint;
+    std::vector<std::string> format;
     MappingDesc *cellDescription;
     std::vector<SliceFieldPrinter<Field> > childs;
 
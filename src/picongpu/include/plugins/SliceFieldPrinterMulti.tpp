@@ -36,6 +36,7 @@
 #include "lambda/Expression.hpp"
 #include "SliceFieldPrinterMulti.hpp"
 #include <sstream>
+#include <stdexcept>
 
 namespace picongpu
 {
@@ -63,6 +64,10 @@ void SliceFieldPrinterMulti<Field>::pluginRegisterHelp(po::options_description&
     desc.add_options()
         ((this->prefix + ".slicePoint").c_str(),
         po::value<std::vector<float_X> > (&this->slicePoint)->multitoken(), "slice point 0.0 <= x <= 1.0");
+    desc.add_options()
+        ((this->prefix + ".format").c_str(),
+        po::value<std::vector<std::string> > (&this->format)->multitoken(),
+        "output format [ascii, binary] (default: ascii)");
 }
 
 template<typename Field>
@@ -79,6 +84,11 @@ void SliceFieldPrinterMulti<Field>::pluginLoad()
         this->childs[i].fileName = this->fileName[i];
         this->childs[i].plane = this->plane[i];
         this->childs[i].slicePoint = this->slicePoint[i];
+        /* the format is optional, missing entries select ASCII output */
+        const std::string childFormat = i < this->format.size() ? this->format[i] : std::string("ascii");
+        if(childFormat != "ascii" && childFormat != "binary")
+            throw std::runtime_error(std::string("SliceFieldPrinter: unknown output format ") + childFormat);
+        this->childs[i].binaryOutput = (childFormat == "binary");
         this->childs[i].pluginLoad();
     }
 }
@@ -561,13 +561,15 @@ public:
              "ADIOS output file")
             ("adios.checkpoint-file", po::value<std::string > (&checkpointFilename),
              "Optional ADIOS checkpoint filename (prefix)")
+            ("adios.checkpoint-posix", po::bool_switch (&mThreadParams.adiosPosixCheckpoint)->default_value(false),
+             "Write checkpoints with the POSIX method, one file per MPI rank (required by --checkpoint-local-directory)")
             ("adios.restart-file", po::value<std::string > (&restartFilename),
              "adios restart filename (prefix)")
             /* 50,000 particles are around 200 frames at 256 particles per frame (each 8k memory)
              * and match ~400MiB with typical picongpu particles.
              **/
             ("adios.restart-chunkSize", po::value<uint32_t > (&restartChunkSize)->default_value(50000),
-             "Number of particles processed in one kernel call during restart to prevent frame count blowup");
+             "Number of particles read and processed in one kernel call during restart to bound host memory and prevent frame count blowup");
     }
 
     std::string pluginGetName() const
@@ -590,6 +592,34 @@ public:
         this->checkpointDirectory = checkpointDirectory;
 
         notificationReceived(currentStep, true);
+
+        if( mThreadParams.adiosPosixCheckpoint )
+        {
+            /* POSIX writes `<file>.bp.dir/<file>.bp.<rank>` on each rank
+             * and the meta file `<file>.bp` on rank 0 */
+            int rank = 0;
+            MPI_CHECK(MPI_Comm_rank(mThreadParams.adiosComm, &rank));
+
+            std::stringstream bpFilename;
+            bpFilename << checkpointFilename << "_" << currentStep << ".bp";
+            const std::string bpBasename(
+                boost::filesystem::path(bpFilename.str()).filename().string());
+
+            std::stringstream subFilename;
+            subFilename << bpFilename.str() << ".dir/" << bpBasename << "." << rank;
+            this->addCheckpointFile(subFilename.str());
+            if( rank == 0 )
+                this->addCheckpointFile(bpFilename.str());
+        }
+    }
+
+    /** Only POSIX checkpoints inside the checkpoint directory are written
+     * to files of their own, MPI_AGGREGATE shares files between ranks
+     */
+    bool hasRankLocalCheckpointFiles() const
+    {
+        return mThreadParams.adiosPosixCheckpoint &&
+            !boost::filesystem::path(checkpointFilename).has_root_path();
     }
 
     void restart(uint32_t restartStep, const std::string restartDirectory)
@@ -987,9 +1017,18 @@ private:
                 (threadParams->adiosBasePath + std::string("iteration")).c_str(),
                 noStatistics));
 
-        /* select MPI method, #OSTs and #aggregators */
-        ADIOS_CMD(adios_select_method(threadParams->adiosGroupHandle,
-                  "MPI_AGGREGATE", mpiTransportParams.c_str(), ""));
+        if( threadParams->isCheckpoint && threadParams->adiosPosixCheckpoint )
+        {
+            /* select POSIX method, one file per MPI rank */
+            ADIOS_CMD(adios_select_method(threadParams->adiosGroupHandle,
+                      "POSIX", "", ""));
+        }
+        else
+        {
+            /* select MPI method, #OSTs and #aggregators */
+            ADIOS_CMD(adios_select_method(threadParams->adiosGroupHandle,
+                      "MPI_AGGREGATE", mpiTransportParams.c_str(), ""));
+        }
 
         threadParams->fieldsOffsetDims = precisionCast<uint64_t>(localDomain.offset);
 
@@ -44,6 +44,9 @@
 #include <boost/mpl/find.hpp>
 #include <boost/type_traits.hpp>
 
+#include <vector>
+#include <algorithm>
+
 
 namespace picongpu
 {
@@ -87,7 +90,8 @@ public:
     /** Load species from ADIOS checkpoint file
      *
      * @param params thread params with ADIOS_FILE, ...
-     * @param restartChunkSize number of particles processed in one kernel call
+     * @param restartChunkSize number of particles read and processed at once,
+     *                         bounds the host memory used for the restart
      */
     HINLINE void operator()(ThreadParams* params, const uint32_t restartChunkSize)
     {
@@ -103,59 +107,123 @@ public:
         /* load particle without copying particle data to host */
         auto speciesTmp = dc.get< ThisSpecies >( ThisSpecies::FrameType::getName(), true );
 
-        /* count total number of particles on the device */
-        uint64_t totalNumParticles = 0;
+        /* number of ranks which wrote the checkpoint, each rank stored
+           (part-count, scalar pos, x, y, z) in the particles info table */
+        const uint64_t localTableSize = 5;
+        const std::string particlesInfoPath( particlePath + std::string("particles_info") );
+        ADIOS_VARINFO* piInfo = adios_inq_var( params->fp, particlesInfoPath.c_str() );
+        const uint64_t numWriters = piInfo->dims[0] / localTableSize;
+        adios_free_varinfo( piInfo );
 
-        /* load particles info table entry for ONE process
-           (note: this is NOT necessarily THIS process!)
-           particlesInfo is (part-count, scalar pos, x, y, z) */
-        uint64_t particlesInfo[5];
+        /* load the particles info table of all writing ranks */
+        std::vector<uint64_t> particlesInfo( localTableSize * numWriters );
 
-        uint64_t start = 5 * gc.getGlobalRank();
-        uint64_t count = 5; // ADIOSCountParticles: uint64_t
+        uint64_t start = 0;
+        uint64_t count = localTableSize * numWriters; // ADIOSCountParticles: uint64_t
         ADIOS_SELECTION* piSel = adios_selection_boundingbox( 1, &start, &count );
 
         ADIOS_CMD(adios_schedule_read( params->fp,
                                        piSel,
-                                       (particlePath + std::string("particles_info")).c_str(),
+                                       particlesInfoPath.c_str(),
                                        0,
                                        1,
-                                       (void*)particlesInfo ));
+                                       (void*)&(*particlesInfo.begin()) ));
 
         /* start a blocking read of all scheduled variables */
         ADIOS_CMD(adios_perform_reads( params->fp, 1 ));
         adios_selection_delete(piSel);
 
-        /* Run a prefix sum over the numParticles[0] element in particlesInfo
-         * to retreive the offset of particles before gc.getGlobalRank() */
-        uint64_t particleOffset = 0;
-
-        uint64_t fullParticlesInfo[gc.getGlobalSize()];
+        /* Run a prefix sum over the part-count entries to retreive the offset
+         * of the particles of each writing rank in the attribute arrays */
+        std::vector<uint64_t> particleOffsets( numWriters, 0 );
+        for (uint64_t i = 1; i < numWriters; ++i)
+            particleOffsets[i] = particleOffsets[i - 1] + particlesInfo[localTableSize * (i - 1)];
+
+        /* blocks of the writing ranks to load
+         *
+         * the table contains only the offset of each block, the extent is
+         * the distance to the next larger offset of the regular domain
+         * decomposition or to the end of the global domain */
+        std::vector<uint64_t> myBlocks;
+        /* a block matching my domain exactly holds all my particles and
+         * needs no filtering, e.g. for a restart with the same decomposition */
+        bool isMyDomainBlock = false;
+
+        const uint64_t posOffset = 2;
+        const PMacc::Selection<simDim>& globalDomain = Environment<simDim>::get().SubGrid().getGlobalDomain();
+        /* same origin as the block offsets written in `ADIOSWriter::writeAdios()` */
+        DataSpace<simDim> myBlockOffset( localDomain.offset );
+        myBlockOffset.y() = std::max( myBlockOffset.y() - params->window.globalDimensions.offset.y(), 0 );
+
+        std::vector<uint64_t> blockOffsets[simDim];
+        for (uint32_t d = 0; d < simDim; ++d)
+        {
+            for (uint64_t i = 0; i < numWriters; ++i)
+                blockOffsets[d].push_back( particlesInfo[localTableSize * i + posOffset + d] );
+            std::sort( blockOffsets[d].begin(), blockOffsets[d].end() );
+            blockOffsets[d].erase(
+                std::unique( blockOffsets[d].begin(), blockOffsets[d].end() ),
+                blockOffsets[d].end()
+            );
+        }
 
-        MPI_CHECK(MPI_Allgather( particlesInfo, 1, MPI_UINT64_T,
-                                 fullParticlesInfo, 1, MPI_UINT64_T,
-                                 gc.getCommunicator().getMPIComm() ));
+        for (uint64_t i = 0; i < numWriters; ++i)
+        {
+            bool overlapsMyDomain = particlesInfo[localTableSize * i] != 0;
+            bool matchesMyDomain = true;
+            for (uint32_t d = 0; d < simDim; ++d)
+            {
+                const uint64_t offset = particlesInfo[localTableSize * i + posOffset + d];
+                std::vector<uint64_t>::const_iterator next = std::upper_bound(
+                    blockOffsets[d].begin(), blockOffsets[d].end(), offset );
+                const uint64_t end = next == blockOffsets[d].end() ?
+                    uint64_t( globalDomain.size[d] ) : *next;
+                const uint64_t myEnd = uint64_t( myBlockOffset[d] + localDomain.size[d] );
+
+                if( offset >= myEnd || end <= uint64_t( myBlockOffset[d] ) )
+                    overlapsMyDomain = false;
+                if( offset != uint64_t( myBlockOffset[d] ) || end != myEnd )
+                    matchesMyDomain = false;
+            }
+            if( matchesMyDomain )
+            {
+                myBlocks.assign( 1, i );
+                isMyDomainBlock = true;
+                break;
+            }
+            if( overlapsMyDomain )
+                myBlocks.push_back( i );
+        }
 
-        for (size_t i = 0; i < gc.getGlobalSize(); ++i)
+        /* count total number of particles to load */
+        uint64_t totalNumParticles = 0;
+        uint64_t numChunks = 0;
+        for (size_t b = 0; b < myBlocks.size(); ++b)
         {
-            /* this comparison is potentially harmful, since the order of ranks
-               is not necessarily the same in subsequent MPI jobs.
-               But due to the wrong sorting by rank in `ADIOSCountParticles.hpp`
-               while calculating the `myParticleOffset` we have to immitate that. */
-            if( i < gc.getGlobalRank() )
-                particleOffset += fullParticlesInfo[i];
-            if( i == gc.getGlobalRank() )
-                totalNumParticles = fullParticlesInfo[i];
+            const uint64_t numParticles = particlesInfo[localTableSize * myBlocks[b]];
+            totalNumParticles += numParticles;
+            numChunks += ( numParticles + restartChunkSize - 1 ) / restartChunkSize;
         }
 
-        log<picLog::INPUT_OUTPUT > ("ADIOS: Loading %1% particles from offset %2%") %
-            (long long unsigned) totalNumParticles % (long long unsigned) particleOffset;
+        /* adios_perform_reads is collective in many ADIOS methods,
+         * ranks with less chunks read empty chunks */
+        uint64_t maxNumChunks = 0;
+        MPI_CHECK(MPI_Allreduce( &numChunks, &maxNumChunks, 1, MPI_UINT64_T,
+                                 MPI_MAX, gc.getCommunicator().getMPIComm() ));
+        maxNumChunks = std::max( maxNumChunks, uint64_t(1) );
+
+        log<picLog::INPUT_OUTPUT > ("ADIOS: Loading %1% particles from %2% of %3% blocks in %4% chunks") %
+            (long long unsigned) totalNumParticles % myBlocks.size() % numWriters % numChunks;
+
+        /* the staging buffer is reused for all chunks,
+         * the host memory is bound by restartChunkSize */
+        const uint64_t stagingSize = std::min( totalNumParticles, uint64_t( restartChunkSize ) );
 
         AdiosFrameType hostFrame;
         log<picLog::INPUT_OUTPUT > ("ADIOS: malloc mapped memory: %1%") % AdiosFrameType::getName();
         /*malloc mapped memory*/
         ForEach<typename AdiosFrameType::ValueTypeSeq, MallocMemory<bmpl::_1> > mallocMem;
-        mallocMem(forward(hostFrame), totalNumParticles);
+        mallocMem(forward(hostFrame), stagingSize);
 
         log<picLog::INPUT_OUTPUT > ("ADIOS: get mapped memory device pointer: %1%") % AdiosFrameType::getName();
         /*load device pointer of mapped memory*/
@@ -164,25 +232,67 @@ public:
         getDevicePtr(forward(deviceFrame), forward(hostFrame));
 
         ForEach<typename AdiosFrameType::ValueTypeSeq, LoadParticleAttributesFromADIOS<bmpl::_1> > loadAttributes;
-        loadAttributes(forward(params), forward(hostFrame), particlePath, particleOffset, totalNumParticles);
 
-        if (totalNumParticles != 0)
+        /* position of the next chunk: block and particle offset within the block */
+        size_t block = 0;
+        uint64_t blockParticleOffset = 0;
+        uint64_t numParticlesInDomain = 0;
+        for (uint64_t chunk = 0; chunk < maxNumChunks; ++chunk)
         {
-            PMacc::particles::operations::splitIntoListOfFrames(
-                *speciesTmp,
-                deviceFrame,
-                totalNumParticles,
-                restartChunkSize,
-                localDomain.offset,
-                totalCellIdx_,
-                *(params->cellDescription),
-                picLog::INPUT_OUTPUT()
-            );
-
-            /*free host memory*/
-            ForEach<typename AdiosFrameType::ValueTypeSeq, FreeMemory<bmpl::_1> > freeMem;
-            freeMem(forward(hostFrame));
+            uint64_t particleOffset = 0;
+            uint64_t numParticles = 0;
+            if( chunk < numChunks )
+            {
+                const uint64_t numBlockParticles = particlesInfo[localTableSize * myBlocks[block]];
+                particleOffset = particleOffsets[myBlocks[block]] + blockParticleOffset;
+                numParticles = std::min(
+                    numBlockParticles - blockParticleOffset,
+                    uint64_t( restartChunkSize )
+                );
+
+                blockParticleOffset += numParticles;
+                if( blockParticleOffset == numBlockParticles )
+                {
+                    ++block;
+                    blockParticleOffset = 0;
+                }
+            }
+            loadAttributes(forward(params), forward(hostFrame), particlePath,
+                           particleOffset, numParticles);
+
+            /* keep only the particles inside my domain */
+            if( !isMyDomainBlock )
+            {
+                numParticles = keepParticlesInCellRange(
+                    hostFrame,
+                    numParticles,
+                    localDomain.offset,
+                    localDomain.size
+                );
+            }
+
+            if (numParticles != 0)
+            {
+                PMacc::particles::operations::splitIntoListOfFrames(
+                    *speciesTmp,
+                    deviceFrame,
+                    numParticles,
+                    restartChunkSize,
+                    localDomain.offset,
+                    totalCellIdx_,
+                    *(params->cellDescription),
+                    picLog::INPUT_OUTPUT()
+                );
+            }
+            numParticlesInDomain += numParticles;
         }
+
+        log<picLog::INPUT_OUTPUT > ("ADIOS: %1% of %2% loaded particles are in the local domain") %
+            (long long unsigned) numParticlesInDomain % (long long unsigned) totalNumParticles;
+
+        /*free host memory*/
+        ForEach<typename AdiosFrameType::ValueTypeSeq, FreeMemory<bmpl::_1> > freeMem;
+        freeMem(forward(hostFrame));
         log<picLog::INPUT_OUTPUT > ("ADIOS: ( end ) load species: %1%") % AdiosFrameType::getName();
     }
 };
@@ -92,8 +92,9 @@ using namespace boost::filesystem;
      * \param filename the file's name
      * \param currentStep the current time step
      * \param checkpointDirectory path to the checkpoint directory
+     * \return name of the copy relative to the checkpoint directory
      */
-    void checkpointTxtFile( std::ofstream& outFile, std::string filename,
+    std::string checkpointTxtFile( std::ofstream& outFile, std::string filename,
                             uint32_t currentStep, const std::string checkpointDirectory )
     {
         outFile.flush();
@@ -102,12 +103,14 @@ using namespace boost::filesystem;
         sStep << currentStep;
 
         path src( filename );
-        path dst( checkpointDirectory + std::string("/") + filename +
-        std::string(".") + sStep.str() );
+        const std::string dstName( filename + std::string(".") + sStep.str() );
+        path dst( checkpointDirectory + std::string("/") + dstName );
 
         copy_file( src,
                    dst,
                    copy_option::overwrite_if_exists );
+
+        return dstName;
     }
 
 } /* namespace picongpu */
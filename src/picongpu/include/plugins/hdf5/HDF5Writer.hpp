@@ -97,7 +97,11 @@ public:
     outputDirectory("h5"),
     checkpointFilename("checkpoint"),
     restartFilename(""), /* set to checkpointFilename by default */
-    notifyPeriod(0)
+    notifyPeriod(0),
+    lastCheckpoint(-1),
+    checkpointDeltas(0),
+    numDeltasSinceFull(0),
+    lastCheckpointSlides(0)
     {
         Environment<>::get().PluginConnector().registerPlugin(this);
     }
@@ -123,8 +127,14 @@ public:
              * The only reason why we use 1M particles per chunk is that we can get a
              * frame overflow in our memory manager if we process all particles in one kernel.
              **/
+            ("hdf5.checkpoint-deltas", po::value<uint32_t > (&checkpointDeltas)->default_value(0),
+             "Number of incremental checkpoints between two full checkpoints, an incremental "
+             "checkpoint stores only the field blocks (super cells) changed since the previous checkpoint")
+            ("hdf5.particle-index", po::bool_switch (&mThreadParams.enableParticleIndex)->default_value(false),
+             "Sort particles by super cell and write the number and offset of the particles "
+             "of each super cell to particles/<species>/superCellIndex")
             ("hdf5.restart-chunkSize", po::value<uint32_t > (&restartChunkSize)->default_value(1000000),
-             "Number of particles processed in one kernel call during restart to prevent frame count blowup");
+             "Number of particles read and processed in one kernel call during restart to bound host memory and prevent frame count blowup");
     }
 
     std::string pluginGetName() const
@@ -155,6 +165,17 @@ public:
 #endif
     }
 
+    bool hasRankLocalCheckpointFiles() const
+    {
+#if(ENABLE_ADIOS == 1)
+        /* checkpoints are written by ADIOS */
+        return true;
+#else
+        /* all ranks write to one file */
+        return false;
+#endif
+    }
+
     void restart(uint32_t restartStep, const std::string restartDirectory)
     {
 #if(ENABLE_ADIOS == 1)
@@ -219,10 +240,30 @@ public:
 
         ThreadParams *params = &mThreadParams;
 
-        /* load all fields */
+        /* a delta checkpoint stores only the changed field blocks,
+         * collect all checkpoints back to the last full checkpoint */
+        std::vector<uint32_t> checkpointChain(1, restartStep);
+        for (int64_t previousStep = readPreviousCheckpointStep(restartStep);
+             previousStep >= 0;
+             previousStep = readPreviousCheckpointStep(checkpointChain.back()))
+        {
+            checkpointChain.push_back(previousStep);
+        }
+
+        /* load all fields of the full checkpoint and apply the deltas */
+        mThreadParams.currentStep = checkpointChain.back();
         ForEach<FileCheckpointFields, LoadFields<bmpl::_1> > forEachLoadFields;
         forEachLoadFields(params);
 
+        for (size_t i = checkpointChain.size() - 1; i-- > 0; )
+        {
+            log<picLog::INPUT_OUTPUT > ("HDF5 apply field deltas of checkpoint %1%") % checkpointChain[i];
+            mThreadParams.currentStep = checkpointChain[i];
+            ForEach<FileCheckpointFields, LoadFieldDeltas<bmpl::_1> > forEachLoadFieldDeltas;
+            forEachLoadFieldDeltas(params);
+        }
+        mThreadParams.currentStep = restartStep;
+
         /* load all particles */
         ForEach<FileCheckpointParticles, LoadSpecies<bmpl::_1> > forEachLoadSpecies;
         forEachLoadSpecies(params, restartChunkSize);
@@ -249,6 +290,27 @@ public:
 
 private:
 
+    /** get the step of the checkpoint a delta checkpoint is based on
+     *
+     * @param checkpointStep step of the checkpoint
+     * @return previous checkpoint step, -1 for a full checkpoint
+     */
+    int64_t readPreviousCheckpointStep(const uint32_t checkpointStep)
+    {
+        int64_t previousStep = -1;
+        try
+        {
+            mThreadParams.dataCollector->readAttribute(checkpointStep, nullptr,
+                                                       "previousCheckpointStep", &previousStep);
+        }
+        catch (const DCException&)
+        {
+            /* checkpoints written without delta checkpoints enabled */
+            previousStep = -1;
+        }
+        return previousStep;
+    }
+
     void closeH5File()
     {
         if (mThreadParams.dataCollector != nullptr)
@@ -336,11 +398,36 @@ private:
             }
         }
 
+        /* delta checkpoints need the block hashes of the previous checkpoint,
+         * a slide of the moving window changes all blocks */
+        mThreadParams.isDeltaCheckpoint = false;
+        mThreadParams.previousCheckpointStep = -1;
+        if( isCheckpoint && mThreadParams.enableDeltaCheckpoints )
+        {
+            const uint32_t slides = MovingWindow::getInstance().getSlideCounter(currentStep);
+            if( lastCheckpoint >= 0 &&
+                numDeltasSinceFull < checkpointDeltas &&
+                slides == lastCheckpointSlides )
+            {
+                mThreadParams.isDeltaCheckpoint = true;
+                mThreadParams.previousCheckpointStep = lastCheckpoint;
+            }
+            log<picLog::INPUT_OUTPUT > ("HDF5: write %1% checkpoint") %
+                (mThreadParams.isDeltaCheckpoint ? "delta" : "full");
+        }
+
         openH5File(mThreadParams.h5Filename);
 
         writeHDF5((void*) &mThreadParams);
 
         closeH5File();
+
+        if( isCheckpoint && mThreadParams.enableDeltaCheckpoints )
+        {
+            numDeltasSinceFull = mThreadParams.isDeltaCheckpoint ? numDeltasSinceFull + 1 : 0;
+            lastCheckpoint = currentStep;
+            lastCheckpointSlides = MovingWindow::getInstance().getSlideCounter(currentStep);
+        }
     }
 
     void pluginLoad()
@@ -378,6 +465,8 @@ private:
             restartFilename = checkpointFilename;
         }
 
+        mThreadParams.enableDeltaCheckpoints = checkpointDeltas > 0;
+
         loaded = true;
     }
 
@@ -440,6 +529,14 @@ private:
         WriteMeta writeMetaAttributes;
         writeMetaAttributes(threadParams);
 
+        if (threadParams->isCheckpoint && threadParams->enableDeltaCheckpoints)
+        {
+            ColTypeInt64 ctInt64;
+            threadParams->dataCollector->writeAttribute(threadParams->currentStep,
+                                                        ctInt64, nullptr, "previousCheckpointStep",
+                                                        &threadParams->previousCheckpointStep);
+        }
+
         return nullptr;
     }
 
@@ -448,7 +545,13 @@ private:
     MappingDesc *cellDescription;
 
     uint32_t notifyPeriod;
+    /* step of the last written checkpoint, -1 if none was written */
     int64_t lastCheckpoint;
+    /* number of delta checkpoints between two full checkpoints */
+    uint32_t checkpointDeltas;
+    uint32_t numDeltasSinceFull;
+    /* slide counter of the moving window at the last checkpoint */
+    uint32_t lastCheckpointSlides;
     std::string filename;
     std::string checkpointFilename;
     std::string restartFilename;
@@ -25,6 +25,7 @@
 #include "simulation_types.hpp"
 #include "plugins/hdf5/HDF5Writer.def"
 #include "plugins/hdf5/writer/Field.hpp"
+#include "plugins/hdf5/writer/FieldDelta.hpp"
 
 #include "dataManagement/DataConnector.hpp"
 
@@ -101,14 +102,22 @@ public:
          *        implementation */
         const float_X timeOffset = 0.0;
 
-        Field::writeField(params,
-                          T::getName(),
-                          getUnit(),
-                          T::getUnitDimension(),
-                          inCellPosition,
-                          timeOffset,
-                          field->getHostDataBox(),
-                          ValueType());
+        /* a delta checkpoint stores only the changed blocks */
+        if( !params->isDeltaCheckpoint )
+            Field::writeField(params,
+                              T::getName(),
+                              getUnit(),
+                              T::getUnitDimension(),
+                              inCellPosition,
+                              timeOffset,
+                              field->getHostDataBox(),
+                              ValueType());
+
+        if( params->isCheckpoint && params->enableDeltaCheckpoints )
+            FieldDelta::writeField(params,
+                                   T::getName(),
+                                   field->getHostDataBox(),
+                                   ValueType());
 
         dc.releaseData( T::getName() );
 #endif
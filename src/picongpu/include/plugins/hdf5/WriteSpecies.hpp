@@ -176,6 +176,34 @@ public:
             PMACC_ASSERT((uint64_t) counterBuffer.getHostBuffer().getDataBox()[0] == numParticles);
         }
 
+        /* super cells of the local and global window,
+         * in units of super cells of the total domain (including slides) */
+        const PMacc::Selection<simDim>& globalDomain = Environment<simDim>::get().SubGrid().getGlobalDomain();
+        const DataSpace<simDim> superCellSize(SuperCellSize::toRT());
+        const DataSpace<simDim> globalWindowBegin(globalDomain.offset + params->window.globalDimensions.offset);
+        const DataSpace<simDim> localWindowBegin(globalWindowBegin + params->window.localDimensions.offset);
+        const DataSpace<simDim> firstSuperCellGlobal(globalWindowBegin / superCellSize);
+        const DataSpace<simDim> firstSuperCellLocal(localWindowBegin / superCellSize);
+        const DataSpace<simDim> numSuperCellsGlobal(
+            (globalWindowBegin + params->window.globalDimensions.size + superCellSize - 1) / superCellSize -
+            firstSuperCellGlobal);
+        const DataSpace<simDim> numSuperCellsLocal(
+            (localWindowBegin + params->window.localDimensions.size + superCellSize - 1) / superCellSize -
+            firstSuperCellLocal);
+
+        std::vector<uint64_t> superCellCounts;
+        if (params->enableParticleIndex)
+        {
+            log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) sort particles by super cell: %1%") % Hdf5FrameType::getName();
+            superCellCounts = sortParticlesBySuperCell(
+                hostFrame,
+                numParticles,
+                firstSuperCellLocal,
+                numSuperCellsLocal
+            );
+            log<picLog::INPUT_OUTPUT > ("HDF5:  ( end ) sort particles by super cell: %1%") % Hdf5FrameType::getName();
+        }
+
         /* We rather do an allgather at this point then letting libSplash
          * do an allgather during write to find out the global number of
          * particles.
@@ -360,7 +388,6 @@ public:
          *         global domain offsets (slides), etc.
          * extent: size of this particle patch, upper bound is excluded
          */
-        const PMacc::Selection<simDim>& globalDomain = Environment<simDim>::get().SubGrid().getGlobalDomain();
         const std::string name_lookup[] = {"x", "y", "z"};
         for (uint32_t d = 0; d < simDim; ++d)
         {
@@ -433,6 +460,22 @@ public:
 
         log<picLog::INPUT_OUTPUT > ("HDF5:  ( end ) writing particlePatches for %1%") % Hdf5FrameType::getName();
 
+        if (params->enableParticleIndex)
+        {
+            log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) writing superCellIndex for %1%") % Hdf5FrameType::getName();
+            writeSuperCellIndex(
+                params,
+                speciesPath + std::string("/superCellIndex"),
+                superCellCounts,
+                numParticlesOffset,
+                firstSuperCellGlobal,
+                numSuperCellsGlobal,
+                firstSuperCellLocal - firstSuperCellGlobal,
+                numSuperCellsLocal
+            );
+            log<picLog::INPUT_OUTPUT > ("HDF5:  ( end ) writing superCellIndex for %1%") % Hdf5FrameType::getName();
+        }
+
         /*free host memory*/
         ForEach<typename Hdf5FrameType::ValueTypeSeq, FreeMemory<bmpl::_1> > freeMem;
         freeMem(forward(hostFrame));
@@ -441,6 +484,102 @@ public:
 
 private:
 
+    /** Writes the number and offset of the particles of each super cell
+     *
+     * The datasets `numParticles` and `numParticlesOffset` have one entry
+     * per super cell of the global window. The offset is the global index of
+     * the first particle of a super cell in the particle records.
+     * The attribute `offset` is the first cell of super cell zero and
+     * `superCellSize` the number of cells per super cell (openPMD cell units,
+     * like the particle patches).
+     *
+     * @param params thread parameters
+     * @param indexPath path to the index group
+     * @param counts number of particles per local super cell
+     * @param numParticlesOffset global index of the first local particle
+     * @param firstSuperCellGlobal first super cell of the global window
+     * @param numSuperCellsGlobal number of super cells of the global window
+     * @param localOffset offset of the local super cells in the global window
+     * @param numSuperCellsLocal number of super cells of the local window
+     */
+    static void writeSuperCellIndex(
+        ThreadParams* params,
+        const std::string indexPath,
+        const std::vector<uint64_t>& counts,
+        const uint64_t numParticlesOffset,
+        const DataSpace<simDim>& firstSuperCellGlobal,
+        const DataSpace<simDim>& numSuperCellsGlobal,
+        const DataSpace<simDim>& localOffset,
+        const DataSpace<simDim>& numSuperCellsLocal
+    )
+    {
+        ColTypeUInt64 ctUInt64;
+        ColTypeDouble ctDouble;
+
+        std::vector<uint64_t> offsets(counts.size(), numParticlesOffset);
+        for (size_t s = 1; s < counts.size(); ++s)
+            offsets[s] = offsets[s - 1] + counts[s - 1];
+
+        Dimensions globalSize(1, 1, 1);
+        Dimensions globalOffset(0, 0, 0);
+        Dimensions localSize(1, 1, 1);
+        for (uint32_t d = 0; d < simDim; ++d)
+        {
+            globalSize[d] = numSuperCellsGlobal[d];
+            globalOffset[d] = localOffset[d];
+            localSize[d] = numSuperCellsLocal[d];
+        }
+
+        params->dataCollector->write(
+            params->currentStep,
+            globalSize,
+            globalOffset,
+            ctUInt64, simDim,
+            localSize,
+            (indexPath + std::string("/numParticles")).c_str(),
+            counts.empty() ? nullptr : &(*counts.begin()));
+
+        params->dataCollector->write(
+            params->currentStep,
+            globalSize,
+            globalOffset,
+            ctUInt64, simDim,
+            localSize,
+            (indexPath + std::string("/numParticlesOffset")).c_str(),
+            offsets.empty() ? nullptr : &(*offsets.begin()));
+
+        const DataSpace<simDim> superCellSize(SuperCellSize::toRT());
+        std::vector<uint64_t> firstCell(simDim);
+        std::vector<uint64_t> cellsPerSuperCell(simDim);
+        for (uint32_t d = 0; d < simDim; ++d)
+        {
+            firstCell[d] = firstSuperCellGlobal[d] * superCellSize[d];
+            cellsPerSuperCell[d] = superCellSize[d];
+        }
+
+        params->dataCollector->writeAttribute(
+            params->currentStep,
+            ctUInt64, indexPath.c_str(),
+            "offset",
+            1u, Dimensions(simDim, 0, 0),
+            &(*firstCell.begin()));
+        params->dataCollector->writeAttribute(
+            params->currentStep,
+            ctUInt64, indexPath.c_str(),
+            "superCellSize",
+            1u, Dimensions(simDim, 0, 0),
+            &(*cellsPerSuperCell.begin()));
+
+        OpenPMDUnit<totalCellIdx> openPMDUnitCellIdx;
+        std::vector<float_64> unitCellIdx = openPMDUnitCellIdx();
+        params->dataCollector->writeAttribute(
+            params->currentStep,
+            ctDouble, indexPath.c_str(),
+            "unitSI",
+            1u, Dimensions(simDim, 0, 0),
+            &(*unitCellIdx.begin()));
+    }
+
     /** Writes a constant particle record (weighted for a real particle)
      *
      * @param params thread parameters
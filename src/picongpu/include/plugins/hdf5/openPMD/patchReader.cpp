@@ -28,15 +28,14 @@ namespace hdf5
 {
 namespace openPMD
 {
-    void PatchReader::checkSpatialTypeSize(
+    uint64_t PatchReader::checkSpatialTypeSize(
             splash::DataCollector* const dc,
-            const uint32_t availableRanks,
             const int32_t id,
             const std::string particlePatchPathComponent
     ) const
     {
-        // will later read into 1D buffer from first position on
-        splash::Dimensions dstBuffer(availableRanks, 1, 1);
+        // only the meta data is read, the buffer size is not used
+        splash::Dimensions dstBuffer(1, 1, 1);
         splash::Dimensions dstOffset(0, 0, 0);
         // sizeRead will be set
         splash::Dimensions sizeRead(0, 0, 0);
@@ -48,32 +47,32 @@ namespace openPMD
             dstOffset,
             sizeRead );
 
-        // check if the 1D list of patches has the right length
-        assert( sizeRead[0] == availableRanks );
+        // the list of patches is 1D
+        assert( sizeRead[1] == 1 && sizeRead[2] == 1 );
 
         // currently only support uint64_t types to spare type conversation
         assert( typeid(*colType) == typeid(splash::ColTypeUInt64) );
 
         // free collections
         __delete( colType );
+
+        return sizeRead[0];
     }
 
     void PatchReader::readPatchAttribute(
         splash::DataCollector* const dc,
-        const uint32_t availableRanks,
+        const uint64_t numPatches,
         const int32_t id,
         const std::string particlePatchPathComponent,
         uint64_t* const dest
     ) const
     {
-        // will later read into 1D buffer from first position on
-        splash::Dimensions dstBuffer(availableRanks, 1, 1);
-        splash::Dimensions dstOffset(0, 0, 0);
         // sizeRead will be set
         splash::Dimensions sizeRead(0, 0, 0);
 
         // check if types, number of patches and names are supported
-        checkSpatialTypeSize( dc, availableRanks, id, particlePatchPathComponent.c_str() );
+        const uint64_t numPatchesRead = checkSpatialTypeSize( dc, id, particlePatchPathComponent.c_str() );
+        assert( numPatchesRead == numPatches );
 
         // read actual offset and extent data of particle patch component
         dc->read( id,
@@ -84,24 +83,29 @@ namespace openPMD
 
     picongpu::openPMD::ParticlePatches PatchReader::operator()(
         splash::DataCollector* const dc,
-        const uint32_t availableRanks,
         const uint32_t dimensionality,
         const int32_t id,
         const std::string particlePatchPath
     ) const
     {
+        // the number of patches is the number of ranks which wrote the file
+        const uint64_t numPatches = checkSpatialTypeSize(
+            dc, id,
+            particlePatchPath + std::string("numParticles")
+        );
+
         // allocate memory for patches
-        picongpu::openPMD::ParticlePatches particlePatches( availableRanks );
+        picongpu::openPMD::ParticlePatches particlePatches( numPatches );
         const std::string name_lookup[] = {"x", "y", "z"};
         for( uint32_t d = 0; d < dimensionality; ++d )
         {
             readPatchAttribute(
-                dc, availableRanks, id,
+                dc, numPatches, id,
                 particlePatchPath + std::string("offset/") + name_lookup[d],
                 particlePatches.getOffsetComp( d )
             );
             readPatchAttribute(
-                dc, availableRanks, id,
+                dc, numPatches, id,
                 particlePatchPath + std::string("extent/") + name_lookup[d],
                 particlePatches.getExtentComp( d )
             );
@@ -109,12 +113,12 @@ namespace openPMD
 
         // read number of particles and their starting point (offset), too
         readPatchAttribute(
-            dc, availableRanks, id,
+            dc, numPatches, id,
             particlePatchPath + std::string("numParticles"),
             &(*particlePatches.numParticles.begin())
         );
         readPatchAttribute(
-            dc, availableRanks, id,
+            dc, numPatches, id,
             particlePatchPath + std::string("numParticlesOffset"),
             &(*particlePatches.numParticlesOffset.begin())
         );
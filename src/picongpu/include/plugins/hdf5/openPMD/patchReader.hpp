@@ -45,7 +45,7 @@ namespace openPMD
     class PatchReader
     {
     private:
-        /** Determine the variable type for `offset` and `extent`
+        /** Determine the variable type and number of patches
          *
          * In particle patches, the `offset` and `extent` can be of
          * user-defined types. This function allows to determine which
@@ -53,20 +53,16 @@ namespace openPMD
          *
          * @note currently we force the type to be `uint64_t`,
          *       we can implement type conversions later on
-         * @note currently we force the number of patches
-         *       to stay constant during restarts
          *
          * @param dc parallel libSplash DataCollector
-         * @param availableRanks MPI ranks in the restarted simulation
-         *        that are currently waiting to find patches
          * @param id iteration in file
          * @param particlePatchPathComponent string such as
          *             "particles/e/particlePatches/numParticles" or
          *             "particles/e/particlePatches/offset/x"
+         * @return number of patches in the file
          */
-        void checkSpatialTypeSize(
+        uint64_t checkSpatialTypeSize(
             splash::DataCollector* const dc,
-            const uint32_t availableRanks,
             const int32_t id,
             const std::string particlePatchPathComponent
         ) const;
@@ -76,18 +72,17 @@ namespace openPMD
          * Read for example: numParticles or offset/x
          *
          * @param[in]  dc pointer to an open splash::DataCollector
-         * @param[in]  availableRanks MPI ranks in the restarted simulation
-         *             that are currently waiting to find patches
+         * @param[in]  numPatches number of patches in the file
          * @param[in]  id time step to read
          * @param[in]  particlePatchPathComponent string such as
          *             "particles/e/particlePatches/numParticles" or
          *             "particles/e/particlePatches/offset/x"
-         * @param[out] dest beginning of c-array of length size()
+         * @param[out] dest beginning of c-array of length numPatches
          *             to write the patch record component to
          */
         void readPatchAttribute(
             splash::DataCollector* const dc,
-            const uint32_t availableRanks,
+            const uint64_t numPatches,
             const int32_t id,
             const std::string particlePatchPathComponent,
             uint64_t* const dest
@@ -95,10 +90,12 @@ namespace openPMD
 
     public:
         /** Build up the global list of patches
+         *
+         * The number of patches is taken from the file, it is the number of
+         * MPI ranks of the simulation which wrote the file and can differ
+         * from the number of ranks of the restarted simulation.
          *
          * @param dc parallel libSplash DataCollector
-         * @param availableRanks MPI ranks in the restarted simulation
-         *        that are currently waiting to find patches
          * @param dimensionality the PIConGPU simDim
          * @param id iteration in file
          * @param particlePatchPath in-file path to a specific particle patch dir
@@ -107,7 +104,6 @@ namespace openPMD
          */
         picongpu::openPMD::ParticlePatches operator()(
             splash::DataCollector* const dc,
-            const uint32_t availableRanks,
             const uint32_t dimensionality,
             const int32_t id,
             const std::string particlePatchPath
@@ -46,6 +46,9 @@
 #include <boost/type_traits.hpp>
 #include <boost/type_traits/is_same.hpp>
 
+#include <vector>
+#include <algorithm>
+
 
 namespace picongpu
 {
@@ -91,7 +94,8 @@ public:
     /** Load species from HDF5 checkpoint file
      *
      * @param params thread params with domainwriter, ...
-     * @param restartChunkSize number of particles processed in one kernel call
+     * @param restartChunkSize number of particles read and processed at once,
+     *                         bounds the host memory used for the restart
      */
     HINLINE void operator()(ThreadParams* params, const uint32_t restartChunkSize)
     {
@@ -109,34 +113,29 @@ public:
         // load particle without copying particle data to host
         auto speciesTmp = dc.get< ThisSpecies >( ThisSpecies::FrameType::getName(), true );
 
-        // count total number of particles on the device
-        uint64_cu totalNumParticles = 0;
-        uint64_t particleOffset = 0;
-
-        // load particle patches offsets to find own patch
+        // load particle patches offsets to find the patches of my domain
         const std::string particlePatchesPath(
             speciesSubGroup + std::string("particlePatches/")
         );
 
-        // read particle patches
+        // read particle patches, one patch per rank of the writing simulation
         openPMD::PatchReader patchReader;
 
         picongpu::openPMD::ParticlePatches particlePatches(
             patchReader(
                 params->dataCollector,
-                gc.getGlobalSize(),
                 simDim,
                 params->currentStep,
                 particlePatchesPath
             )
         );
 
-        /** search my entry (using my cell offset and my local grid size)
+        /** search all patches overlapping my domain (using my cell offset and
+         * my local grid size)
          *
-         * \note if you want to restart with a changed GPU configuration, either
-         * post-process the particle-patches in the file or implement to find
-         * all contributing patches and then filter the particles inside those
-         * by position
+         * If the domain decomposition is unchanged exactly one patch matches
+         * and all its particles are loaded. Otherwise the particles of all
+         * overlapping patches are loaded and filtered by their cell index.
          *
          * \see plugins/hdf5/WriteSpecies.hpp `WriteSpecies::operator()`
          *      as its counterpart
@@ -148,34 +147,66 @@ public:
         const DataSpace<simDim> patchExtent =
             params->window.localDimensions.size;
 
-        for( size_t i = 0; i < gc.getGlobalSize(); ++i )
+        std::vector<size_t> myPatches;
+        bool isExactlyMyPatch = false;
+        for( size_t i = 0; i < particlePatches.size(); ++i )
         {
             bool exactlyMyPatch = true;
+            bool overlapsMyPatch = true;
 
             for( uint32_t d = 0; d < simDim; ++d )
             {
-                if( particlePatches.getOffsetComp( d )[ i ] != (uint64_t)patchOffset[ d ] )
-                    exactlyMyPatch = false;
-                if( particlePatches.getExtentComp( d )[ i ] != (uint64_t)patchExtent[ d ] )
+                const uint64_t offset = particlePatches.getOffsetComp( d )[ i ];
+                const uint64_t extent = particlePatches.getExtentComp( d )[ i ];
+
+                if( offset != (uint64_t)patchOffset[ d ] || extent != (uint64_t)patchExtent[ d ] )
                     exactlyMyPatch = false;
+                if( offset >= (uint64_t)( patchOffset[ d ] + patchExtent[ d ] ) ||
+                    offset + extent <= (uint64_t)patchOffset[ d ] )
+                    overlapsMyPatch = false;
             }
 
             if( exactlyMyPatch )
             {
-                totalNumParticles = particlePatches.numParticles[ i ];
-                particleOffset = particlePatches.numParticlesOffset[ i ];
+                myPatches.assign( 1, i );
+                isExactlyMyPatch = true;
                 break;
             }
+            if( overlapsMyPatch && particlePatches.numParticles[ i ] != 0 )
+                myPatches.push_back( i );
         }
 
-        log<picLog::INPUT_OUTPUT > ("Loading %1% particles from offset %2%") %
-            (long long unsigned) totalNumParticles % (long long unsigned) particleOffset;
+        // count total number of particles to load
+        uint64_t totalNumParticles = 0;
+        uint64_t numChunks = 0;
+        for( size_t p = 0; p < myPatches.size(); ++p )
+        {
+            const uint64_t numParticles = particlePatches.numParticles[ myPatches[ p ] ];
+            totalNumParticles += numParticles;
+            numChunks += ( numParticles + restartChunkSize - 1 ) / restartChunkSize;
+        }
+
+        /* all ranks must read the same number of chunks,
+         * ranks with less chunks read empty chunks
+         */
+        uint64_t maxNumChunks = 0;
+        MPI_CHECK(MPI_Allreduce( &numChunks, &maxNumChunks, 1, MPI_UINT64_T,
+                                 MPI_MAX, gc.getCommunicator().getMPIComm() ));
+        maxNumChunks = std::max( maxNumChunks, uint64_t(1) );
+
+        log<picLog::INPUT_OUTPUT > ("HDF5:  Loading %1% particles from %2% patches in %3% chunks") %
+            (long long unsigned) totalNumParticles % myPatches.size() % numChunks;
+
+        /* the staging buffer is reused for all chunks,
+         * the host memory is bound by restartChunkSize
+         */
+        const uint64_t stagingSize = std::min( totalNumParticles, uint64_t( restartChunkSize ) );
 
         Hdf5FrameType hostFrame;
         log<picLog::INPUT_OUTPUT > ("HDF5:  malloc mapped memory: %1%") % Hdf5FrameType::getName();
         /*malloc mapped memory*/
         ForEach<typename Hdf5FrameType::ValueTypeSeq, MallocMemory<bmpl::_1> > mallocMem;
-        mallocMem(forward(hostFrame), totalNumParticles);
+        mallocMem(forward(hostFrame), stagingSize);
 
         log<picLog::INPUT_OUTPUT > ("HDF5:  get mapped memory device pointer: %1%") % Hdf5FrameType::getName();
         /*load device pointer of mapped memory*/
@@ -184,26 +215,69 @@ public:
         getDevicePtr(forward(deviceFrame), forward(hostFrame));
 
         ForEach<typename Hdf5FrameType::ValueTypeSeq, LoadParticleAttributesFromHDF5<bmpl::_1> > loadAttributes;
-        loadAttributes(forward(params), forward(hostFrame), speciesSubGroup, particleOffset, totalNumParticles);
 
-        if (totalNumParticles != 0)
+        // position of the next chunk: patch and particle offset within the patch
+        size_t patch = 0;
+        uint64_t patchParticleOffset = 0;
+        uint64_t numParticlesInDomain = 0;
+        for( uint64_t chunk = 0; chunk < maxNumChunks; ++chunk )
         {
-            PMacc::particles::operations::splitIntoListOfFrames(
-                *speciesTmp,
-                deviceFrame,
-                totalNumParticles,
-                restartChunkSize,
-                globalDomain.offset + localDomain.offset,
-                totalCellIdx_,
-                *(params->cellDescription),
-                picLog::INPUT_OUTPUT()
-            );
-
-            /*free host memory*/
-            ForEach<typename Hdf5FrameType::ValueTypeSeq, FreeMemory<bmpl::_1> > freeMem;
-            freeMem(forward(hostFrame));
-            log<picLog::INPUT_OUTPUT > ("HDF5: ( end ) load species: %1%") % Hdf5FrameType::getName();
+            uint64_t particleOffset = 0;
+            uint64_t numParticles = 0;
+            if( chunk < numChunks )
+            {
+                const uint64_t numPatchParticles = particlePatches.numParticles[ myPatches[ patch ] ];
+                particleOffset = particlePatches.numParticlesOffset[ myPatches[ patch ] ] +
+                    patchParticleOffset;
+                numParticles = std::min(
+                    numPatchParticles - patchParticleOffset,
+                    uint64_t( restartChunkSize )
+                );
+
+                patchParticleOffset += numParticles;
+                if( patchParticleOffset == numPatchParticles )
+                {
+                    ++patch;
+                    patchParticleOffset = 0;
+                }
+            }
+            loadAttributes(forward(params), forward(hostFrame), speciesSubGroup,
+                           particleOffset, numParticles);
+
+            // keep only the particles inside my domain
+            if( !isExactlyMyPatch )
+            {
+                numParticles = keepParticlesInCellRange(
+                    hostFrame,
+                    numParticles,
+                    globalDomain.offset + localDomain.offset,
+                    localDomain.size
+                );
+            }
+
+            if (numParticles != 0)
+            {
+                PMacc::particles::operations::splitIntoListOfFrames(
+                    *speciesTmp,
+                    deviceFrame,
+                    numParticles,
+                    restartChunkSize,
+                    globalDomain.offset + localDomain.offset,
+                    totalCellIdx_,
+                    *(params->cellDescription),
+                    picLog::INPUT_OUTPUT()
+                );
+            }
+            numParticlesInDomain += numParticles;
         }
+
+        log<picLog::INPUT_OUTPUT > ("HDF5:  %1% of %2% loaded particles are in the local domain") %
+            (long long unsigned) numParticlesInDomain % (long long unsigned) totalNumParticles;
+
+        /*free host memory*/
+        ForEach<typename Hdf5FrameType::ValueTypeSeq, FreeMemory<bmpl::_1> > freeMem;
+        freeMem(forward(hostFrame));
+        log<picLog::INPUT_OUTPUT > ("HDF5: ( end ) load species: %1%") % Hdf5FrameType::getName();
     }
 };
 
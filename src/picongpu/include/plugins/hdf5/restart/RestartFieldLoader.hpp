@@ -29,11 +29,14 @@
 #include "dataManagement/DataConnector.hpp"
 #include "dimensions/DataSpace.hpp"
 #include "dimensions/GridLayout.hpp"
+#include "plugins/hdf5/writer/FieldDelta.hpp"
 
 #include <splash/splash.h>
 
 #include <string>
 #include <sstream>
+#include <vector>
+#include <algorithm>
 
 
 namespace picongpu
@@ -118,6 +121,102 @@ public:
         log<picLog::INPUT_OUTPUT > ("Finished loading field '%1%'") % objectName;
     }
 
+    /** apply the changed blocks of a delta checkpoint to a loaded field
+     *
+     * The field must contain the data of the previous checkpoint in its
+     * host buffer.
+     *
+     * @see FieldDelta
+     */
+    template<class Data>
+    static void loadFieldDelta(Data& field, const uint32_t numComponents, std::string objectName, ThreadParams *params)
+    {
+        typedef FieldDelta::BlockSize BlockSize;
+        constexpr uint32_t blockVolume = PMacc::math::CT::volume<BlockSize>::type::value;
+
+        log<picLog::INPUT_OUTPUT > ("Begin loading field delta '%1%' of step %2%") %
+            objectName % params->currentStep;
+
+        uint64_t numBlocksGlobal = 0;
+        params->dataCollector->readAttribute(params->currentStep, nullptr,
+                                             FieldDelta::getNumBlocksName(objectName).c_str(),
+                                             &numBlocksGlobal);
+        if (numBlocksGlobal == 0)
+            return;
+
+        const std::string path(FieldDelta::getPath(objectName));
+        const PMacc::Selection<simDim>& localDomain = Environment<simDim>::get().SubGrid().getLocalDomain();
+        const DataSpace<simDim> globalBlocks = FieldDelta::getGlobalBlocks();
+
+        /* the index list is small (one entry per changed block), read it
+         * completely and search the range of blocks of the local domain */
+        std::vector<uint64_t> blockIdx(numBlocksGlobal);
+        Dimensions sizeRead(0, 0, 0);
+        params->dataCollector->read(params->currentStep,
+                                    (path + std::string("blockIdx")).c_str(),
+                                    sizeRead,
+                                    &(*blockIdx.begin()));
+
+        std::vector<DataSpace<simDim> > localCellOffsets(numBlocksGlobal);
+        std::vector<bool> isLocal(numBlocksGlobal, false);
+        uint64_t firstBlock = numBlocksGlobal;
+        uint64_t endBlock = 0;
+        for (uint64_t i = 0; i < numBlocksGlobal; ++i)
+        {
+            localCellOffsets[i] =
+                DataSpaceOperations<simDim>::map(globalBlocks, blockIdx[i]) * BlockSize::toRT() -
+                localDomain.offset;
+            bool inside = true;
+            for (uint32_t d = 0; d < simDim; ++d)
+                if (localCellOffsets[i][d] < 0 || localCellOffsets[i][d] >= localDomain.size[d])
+                    inside = false;
+            if (inside)
+            {
+                isLocal[i] = true;
+                firstBlock = std::min(firstBlock, i);
+                endBlock = i + 1;
+            }
+        }
+        /* blocks are stored per writing rank, with an unchanged domain
+         * decomposition the local blocks are contiguous */
+        const uint64_t numBlocks = firstBlock < endBlock ? endBlock - firstBlock : 0;
+        if (numBlocks == 0)
+            firstBlock = 0;
+
+        const std::string name_lookup[] = {"x", "y", "z"};
+        const DataSpace<simDim> field_guard = field.getGridLayout().getGuard();
+        auto destBox = field.getHostBuffer().getDataBox().shift(field_guard);
+        std::vector<float_X> tmpArray(numBlocks * blockVolume);
+        for (uint32_t n = 0; n < numComponents; ++n)
+        {
+            params->dataCollector->read(params->currentStep,
+                                        Dimensions(numBlocks * blockVolume, 1, 1),
+                                        Dimensions(firstBlock * blockVolume, 0, 0),
+                                        (path + name_lookup[n]).c_str(),
+                                        sizeRead,
+                                        numBlocks != 0 ? &(*tmpArray.begin()) : nullptr);
+
+            for (uint64_t i = firstBlock; i < endBlock; ++i)
+            {
+                if (!isLocal[i])
+                    continue;
+                for (uint32_t c = 0; c < blockVolume; ++c)
+                {
+                    const DataSpace<simDim> cellIdx =
+                        localCellOffsets[i] + DataSpaceOperations<simDim>::template map<BlockSize>(c);
+                    destBox(cellIdx)[n] = tmpArray[(i - firstBlock) * blockVolume + c];
+                }
+            }
+        }
+
+        field.hostToDevice();
+
+        __getTransactionEvent().waitForFinished();
+
+        log<picLog::INPUT_OUTPUT > ("Finished loading field delta '%1%': %2% blocks") %
+            objectName % numBlocks;
+    }
+
     template<class Data>
     static void cloneField(Data& fieldDest, Data& fieldSrc, std::string objectName)
     {
@@ -173,6 +272,37 @@ public:
 
 };
 
+/**
+ * Hepler class for HDF5Writer (forEach operator) to apply the changed
+ * blocks of a delta checkpoint to a field loaded from a previous checkpoint
+ *
+ * @tparam FieldType field class to load
+ */
+template< typename FieldType >
+struct LoadFieldDeltas
+{
+public:
+
+    HDINLINE void operator()(ThreadParams* params)
+    {
+#ifndef __CUDA_ARCH__
+        DataConnector &dc = Environment<>::get().DataConnector();
+
+        /* the host buffer still contains the previous checkpoint */
+        std::shared_ptr< FieldType > field = dc.get< FieldType >( FieldType::getName(), true );
+
+        RestartFieldLoader::loadFieldDelta(
+                field->getGridBuffer(),
+                (uint32_t)FieldType::numComponents,
+                FieldType::getName(),
+                params);
+
+        dc.releaseData( FieldType::getName() );
+#endif
+    }
+
+};
+
 using namespace PMacc;
 using namespace splash;
 
@@ -0,0 +1,216 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of PIConGPU.
+ *
+ * PIConGPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * PIConGPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PIConGPU.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "simulation_types.hpp"
+#include "plugins/hdf5/HDF5Writer.def"
+#include "traits/PICToSplash.hpp"
+#include "traits/GetComponentsType.hpp"
+#include "traits/GetNComponents.hpp"
+#include "dimensions/DataSpaceOperations.hpp"
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace picongpu
+{
+
+namespace hdf5
+{
+
+using namespace PMacc;
+using namespace splash;
+
+/** field blocks of incremental (delta) checkpoints
+ *
+ * A field is split into blocks of one super cell. For each block a hash of
+ * its data in the last checkpoint is kept. A delta checkpoint stores only the
+ * blocks with a changed hash in the 1D data sets
+ * `fieldDeltas/<name>/blockIdx` (linear index of the block in the global
+ * block grid) and `fieldDeltas/<name>/<component>` (values of all cells of
+ * the blocks, cells ordered like within a super cell).
+ */
+struct FieldDelta
+{
+    typedef SuperCellSize BlockSize;
+
+    /** name of the root attribute with the global number of stored blocks */
+    static std::string getNumBlocksName(const std::string& name)
+    {
+        return std::string("fieldDeltaBlocks_") + name;
+    }
+
+    static std::string getPath(const std::string& name)
+    {
+        return std::string("fieldDeltas/") + name + std::string("/");
+    }
+
+    /** number of blocks of the global domain */
+    static DataSpace<simDim> getGlobalBlocks()
+    {
+        return Environment<simDim>::get().SubGrid().getGlobalDomain().size / BlockSize::toRT();
+    }
+
+    /** number of blocks of the local domain */
+    static DataSpace<simDim> getLocalBlocks()
+    {
+        return Environment<simDim>::get().SubGrid().getLocalDomain().size / BlockSize::toRT();
+    }
+
+    /** update the block hashes of a field and write the changed blocks
+     *
+     * The blocks are only written in a delta checkpoint, in a full checkpoint
+     * only the hashes are updated.
+     *
+     * @param params thread params with the data collector and the hashes
+     * @param name field name
+     * @param dataBox host data box of the field including guards
+     */
+    template<typename T_ValueType, typename T_DataBoxType>
+    static void writeField(ThreadParams *params,
+                           const std::string name,
+                           T_DataBoxType dataBox,
+                           const T_ValueType&)
+    {
+        typedef T_ValueType ValueType;
+        typedef typename GetComponentsType<ValueType>::type ComponentType;
+        typedef typename PICToSplash<ComponentType>::type SplashType;
+
+        const uint32_t nComponents = GetNComponents<ValueType>::value;
+        constexpr uint32_t blockVolume = PMacc::math::CT::volume<BlockSize>::type::value;
+
+        const PMacc::Selection<simDim>& localDomain = Environment<simDim>::get().SubGrid().getLocalDomain();
+        const DataSpace<simDim> localBlocks = getLocalBlocks();
+        const DataSpace<simDim> globalBlocks = getGlobalBlocks();
+        const DataSpace<simDim> blockOffset = localDomain.offset / BlockSize::toRT();
+        const size_t numLocalBlocks = localBlocks.productOfComponents();
+
+        auto fieldBox = dataBox.shift(params->gridLayout.getGuard());
+
+        std::vector<uint64_t>& hashes = params->fieldBlockHashes[name];
+        const bool hasHashes = hashes.size() == numLocalBlocks;
+        hashes.resize(numLocalBlocks, 0);
+
+        /* hash all blocks and collect the changed blocks */
+        std::vector<uint64_t> changedBlocks;
+        for (size_t b = 0; b < numLocalBlocks; ++b)
+        {
+            const DataSpace<simDim> cellOffset =
+                DataSpaceOperations<simDim>::map(localBlocks, b) * BlockSize::toRT();
+
+            /* FNV-1a over the bytes of all components */
+            uint64_t hash = 14695981039346656037llu;
+            for (uint32_t c = 0; c < blockVolume; ++c)
+            {
+                const DataSpace<simDim> cellIdx =
+                    cellOffset + DataSpaceOperations<simDim>::template map<BlockSize>(c);
+                const ValueType value = fieldBox(cellIdx);
+                const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+                for (size_t i = 0; i < sizeof(ValueType); ++i)
+                {
+                    hash ^= bytes[i];
+                    hash *= 1099511628211llu;
+                }
+            }
+
+            if (!hasHashes || hashes[b] != hash)
+                changedBlocks.push_back(b);
+            hashes[b] = hash;
+        }
+
+        if (!params->isDeltaCheckpoint)
+            return;
+
+        /* offset of my blocks in the data sets */
+        GridController<simDim>& gc = Environment<simDim>::get().GridController();
+        uint64_t numBlocks = changedBlocks.size();
+        uint64_t numBlocksOffset = 0;
+        uint64_t numBlocksGlobal = 0;
+        MPI_CHECK(MPI_Exscan(&numBlocks, &numBlocksOffset, 1, MPI_UINT64_T, MPI_SUM,
+                             gc.getCommunicator().getMPIComm()));
+        MPI_CHECK(MPI_Allreduce(&numBlocks, &numBlocksGlobal, 1, MPI_UINT64_T, MPI_SUM,
+                                gc.getCommunicator().getMPIComm()));
+        /* the result of MPI_Exscan is undefined on the first rank */
+        if (gc.getGlobalRank() == 0)
+            numBlocksOffset = 0;
+
+        log<picLog::INPUT_OUTPUT > ("HDF5 write field delta: %1% %2% of %3% blocks changed") %
+            name % numBlocks % numLocalBlocks;
+
+        ColTypeUInt64 ctUInt64;
+        params->dataCollector->writeAttribute(params->currentStep,
+                                              ctUInt64, nullptr,
+                                              getNumBlocksName(name).c_str(),
+                                              &numBlocksGlobal);
+        if (numBlocksGlobal == 0)
+            return;
+
+        const std::string path(getPath(name));
+
+        std::vector<uint64_t> blockIdx(numBlocks);
+        for (size_t i = 0; i < numBlocks; ++i)
+        {
+            const DataSpace<simDim> globalBlockIdx =
+                blockOffset + DataSpaceOperations<simDim>::map(localBlocks, changedBlocks[i]);
+            blockIdx[i] = DataSpaceOperations<simDim>::map(globalBlocks, globalBlockIdx);
+        }
+
+        params->dataCollector->write(params->currentStep,
+                                     Dimensions(numBlocksGlobal, 1, 1),
+                                     Dimensions(numBlocksOffset, 0, 0),
+                                     ctUInt64, 1,
+                                     Dimensions(numBlocks, 1, 1),
+                                     (path + std::string("blockIdx")).c_str(),
+                                     numBlocks != 0 ? &(*blockIdx.begin()) : nullptr);
+
+        const std::string name_lookup[] = {"x", "y", "z", "w"};
+        SplashType splashType;
+        std::vector<ComponentType> tmpArray(numBlocks * blockVolume);
+        for (uint32_t n = 0; n < nComponents; ++n)
+        {
+            for (size_t i = 0; i < numBlocks; ++i)
+            {
+                const DataSpace<simDim> cellOffset =
+                    DataSpaceOperations<simDim>::map(localBlocks, changedBlocks[i]) * BlockSize::toRT();
+                for (uint32_t c = 0; c < blockVolume; ++c)
+                {
+                    const DataSpace<simDim> cellIdx =
+                        cellOffset + DataSpaceOperations<simDim>::template map<BlockSize>(c);
+                    tmpArray[i * blockVolume + c] = fieldBox(cellIdx)[n];
+                }
+            }
+
+            params->dataCollector->write(params->currentStep,
+                                         Dimensions(numBlocksGlobal * blockVolume, 1, 1),
+                                         Dimensions(numBlocksOffset * blockVolume, 0, 0),
+                                         splashType, 1,
+                                         Dimensions(numBlocks * blockVolume, 1, 1),
+                                         (path + name_lookup[n]).c_str(),
+                                         numBlocks != 0 ? &(*tmpArray.begin()) : nullptr);
+        }
+    }
+};
+
+} //namspace hdf5
+
+} //namespace picongpu
@@ -22,6 +22,7 @@
 #include "mappings/simulation/GridController.hpp"
 #include "memory/boxes/PitchedBox.hpp"
 #include "header/MessageHeader.hpp"
+#include "compression/ZipConnector.hpp"
 
 #include "simulation_defines.hpp"
 
@@ -30,6 +31,7 @@
 #include <mpi.h>
 
 #include <vector>
+#include <algorithm>
 
 #include <sys/stat.h>
 
@@ -37,6 +39,14 @@ namespace picongpu
 {
 using namespace PMacc;
 
+/** gather the image tiles of all ranks to a master rank
+ *
+ * Each rank compresses its tile (zlib) before it is sent, tiles without
+ * data (all values zero) are not sent at all. The master inserts the tiles
+ * into the image in the order they arrive, therefore only the compressed
+ * tiles and one uncompressed tile are held in addition to the image.
+ * All buffers are reused between calls.
+ */
 struct GatherSlice
 {
 
@@ -45,7 +55,6 @@ struct GatherSlice
         numRanks(0),
         filteredData(nullptr),
         comm(MPI_COMM_NULL),
-        fullData(nullptr),
         masterRank(0),
         isMPICommInitialized(false)
     {
@@ -116,82 +125,111 @@ struct GatherSlice
     {
         typedef typename Box::ValueType ValueType;
 
-        Box dstBox = Box(PitchedBox<ValueType, DIM2 > (
-                                                       (ValueType*) filteredData,
-                                                       DataSpace<DIM2 > (),
-                                                       header.sim.size,
-                                                       header.sim.size.x() * sizeof (ValueType)
-                                                       ));
-
-        MessageHeader* fakeHeader = MessageHeader::create();
-        memcpy(fakeHeader, &header, sizeof (MessageHeader));
-
-        char* recvHeader = new char[ MessageHeader::bytes * numRanks];
-
-        if (fullData == nullptr && mpiRank == masterRank)
-            fullData = (char*) new ValueType[header.sim.size.productOfComponents()];
-
-
-        MPI_CHECK(MPI_Gather(fakeHeader, MessageHeader::bytes, MPI_CHAR, recvHeader, MessageHeader::bytes,
-                             MPI_CHAR, masterRank, comm));
-
-        std::vector<int> counts(numRanks);
-        std::vector<int> displs(numRanks);
-        int offset = 0;
-        for (int i = 0; i < numRanks; ++i)
+        const size_t tileBytes = header.node.maxSize.productOfComponents() * sizeof (ValueType);
+
+        /* describe and compress the local tile */
+        TileInfo localTile;
+        localTile.offset[0] = header.node.offset.x();
+        localTile.offset[1] = header.node.offset.y();
+        localTile.size[0] = header.node.maxSize.x();
+        localTile.size[1] = header.node.maxSize.y();
+
+        const char* tileData = (const char*) (data.getPointer());
+        const bool isEmpty = std::find_if(tileData, tileData + tileBytes,
+                                          [](char const c){ return c != 0; }) == tileData + tileBytes;
+        localTile.bytes = 0;
+        localTile.isCompressed = 0;
+        const char* sendData = tileData;
+        if (!isEmpty)
         {
-            MessageHeader* head = (MessageHeader*) (recvHeader + MessageHeader::bytes * i);
-            counts[i] = head->node.maxSize.productOfComponents() * sizeof (ValueType);
-            displs[i] = offset;
-            offset += counts[i];
+            compressedTile.resize(tileBytes);
+            ZipConnector zip;
+            /* fastest compression level, the images contain large uniform areas */
+            const size_t compressedBytes = zip.compress(&compressedTile[0], tileBytes,
+                                                        (void*) tileData, tileBytes, 1);
+            if (compressedBytes != 0)
+            {
+                localTile.bytes = compressedBytes;
+                localTile.isCompressed = 1;
+                sendData = &compressedTile[0];
+            }
+            else
+                localTile.bytes = tileBytes;
         }
 
-        const size_t elementsCount = header.node.maxSize.productOfComponents() * sizeof (ValueType);
-
-        MPI_CHECK(MPI_Gatherv(
-                              (char*) (data.getPointer()), elementsCount, MPI_CHAR,
-                              fullData, &counts[0], &displs[0], MPI_CHAR,
-                              masterRank, comm));
-
+        const bool isMaster = mpiRank == masterRank;
+        tiles.resize(isMaster ? numRanks : 0);
+        MPI_CHECK(MPI_Gather(&localTile, sizeof (TileInfo), MPI_CHAR,
+                             isMaster ? &tiles[0] : nullptr, sizeof (TileInfo), MPI_CHAR,
+                             masterRank, comm));
 
-
-        if (mpiRank == masterRank)
+        if (!isMaster)
         {
-            log<picLog::DOMAINS > ("Master create image");
-            if (filteredData == nullptr)
-                filteredData = (char*) new ValueType[header.sim.size.productOfComponents()];
+            if (localTile.bytes != 0)
+                MPI_CHECK(MPI_Send((void*) sendData, localTile.bytes, MPI_CHAR, masterRank, tileTag, comm));
+            return Box(PitchedBox<ValueType, DIM2 > (
+                                                     (ValueType*) filteredData,
+                                                     DataSpace<DIM2 > (),
+                                                     header.sim.size,
+                                                     header.sim.size.x() * sizeof (ValueType)
+                                                     ));
+        }
+
+        log<picLog::DOMAINS > ("Master create image");
+        if (filteredData == nullptr)
+            filteredData = (char*) new ValueType[header.sim.size.productOfComponents()];
 
-            /*create box with valid memory*/
-            dstBox = Box(PitchedBox<ValueType, DIM2 > (
+        /*create box with valid memory*/
+        Box dstBox = Box(PitchedBox<ValueType, DIM2 > (
                                                        (ValueType*) filteredData,
                                                        DataSpace<DIM2 > (),
                                                        header.sim.size,
                                                        header.sim.size.x() * sizeof (ValueType)
                                                        ));
 
-            for (int i = 0; i < numRanks; ++i)
-            {
-                MessageHeader* head = (MessageHeader*) (recvHeader + MessageHeader::bytes * i);
-
-                log<picLog::DOMAINS > ("part image with offset %1%byte=%2%elements | size %3%  | offset %4%") %
-                    displs[i] % (displs[i] / sizeof (ValueType)) %
-                    head->node.maxSize.toString() %
-                    head->node.offset.toString();
-                Box srcBox = Box(PitchedBox<ValueType, DIM2 > (
-                                                               (ValueType*) (fullData + displs[i]),
-                                                               DataSpace<DIM2 > (),
-                                                               head->node.maxSize,
-                                                               head->node.maxSize.x() * sizeof (ValueType)
-                                                               ));
-
-                insertData(dstBox, srcBox, head->node.offset, head->node.maxSize);
-            }
+        /* receive all non-empty tiles into one buffer of compressed data */
+        size_t recvBytes = 0;
+        for (int i = 0; i < numRanks; ++i)
+            if (i != masterRank)
+                recvBytes += tiles[i].bytes;
+        recvBuffer.resize(std::max(recvBytes, size_t(1)));
+
+        std::vector<MPI_Request> requests;
+        std::vector<int> requestRanks;
+        requests.reserve(numRanks);
+        requestRanks.reserve(numRanks);
+        size_t offset = 0;
+        for (int i = 0; i < numRanks; ++i)
+        {
+            if (i == masterRank || tiles[i].bytes == 0)
+                continue;
+            requests.push_back(MPI_REQUEST_NULL);
+            requestRanks.push_back(i);
+            MPI_CHECK(MPI_Irecv(&recvBuffer[offset], tiles[i].bytes, MPI_CHAR, i, tileTag, comm,
+                                &requests.back()));
+            tiles[i].recvOffset = offset;
+            offset += tiles[i].bytes;
+        }
 
-            __deleteArray(fullData);
+        /* insert the local tile and all empty tiles while the data is in flight */
+        for (int i = 0; i < numRanks; ++i)
+        {
+            if (i == masterRank)
+                insertTile<Box>(dstBox, tiles[i], tileData, tileBytes);
+            else if (tiles[i].bytes == 0)
+                insertTile<Box>(dstBox, tiles[i], nullptr, tileBytes);
         }
 
-        delete[] recvHeader;
-        MessageHeader::destroy(fakeHeader);
+        /* insert the remote tiles in the order they arrive */
+        for (size_t n = 0; n < requests.size(); ++n)
+        {
+            int index = MPI_UNDEFINED;
+            MPI_CHECK(MPI_Waitany(requests.size(), &requests[0], &index, MPI_STATUS_IGNORE));
+            const TileInfo& tile = tiles[requestRanks[index]];
+            log<picLog::DOMAINS > ("part image from rank %1% | size %2%x%3% | offset %4%x%5% | %6% byte") %
+                requestRanks[index] % tile.size[0] % tile.size[1] % tile.offset[0] % tile.offset[1] % tile.bytes;
+            insertTile<Box>(dstBox, tile, &recvBuffer[tile.recvOffset], tileBytes);
+        }
 
         return dstBox;
     }
@@ -210,6 +248,59 @@ struct GatherSlice
 
 private:
 
+    /** description of the tile of one rank */
+    struct TileInfo
+    {
+        /* offset of the tile to the origin of the simulation */
+        int offset[2];
+        /* size of the tile */
+        int size[2];
+        /* number of bytes sent, zero if all values are zero */
+        int bytes;
+        /* one if the data is compressed, zero if it is sent raw */
+        int isCompressed;
+        /* position of the data in recvBuffer, only used on the master */
+        size_t recvOffset;
+    };
+
+    /** insert a received tile into the image
+     *
+     * @param dst image
+     * @param tile description of the tile
+     * @param tileData data as received, nullptr for an empty tile
+     * @param maxTileBytes maximum size of an uncompressed tile
+     */
+    template<class Box>
+    void insertTile(Box& dst, const TileInfo& tile, const char* tileData, size_t maxTileBytes)
+    {
+        typedef typename Box::ValueType ValueType;
+
+        const Size2D size(tile.size[0], tile.size[1]);
+        const Size2D offset(tile.offset[0], tile.offset[1]);
+        const size_t bytes = size.productOfComponents() * sizeof (ValueType);
+
+        if (tileData == nullptr)
+        {
+            tileBuffer.assign(bytes, 0);
+            tileData = &tileBuffer[0];
+        }
+        else if (tile.isCompressed)
+        {
+            tileBuffer.resize(std::max(bytes, maxTileBytes));
+            ZipConnector zip;
+            zip.decompress(&tileBuffer[0], (void*) tileData, tile.bytes, tileBuffer.size());
+            tileData = &tileBuffer[0];
+        }
+
+        Box srcBox = Box(PitchedBox<ValueType, DIM2 > (
+                                                       (ValueType*) tileData,
+                                                       DataSpace<DIM2 > (),
+                                                       size,
+                                                       size.x() * sizeof (ValueType)
+                                                       ));
+        insertData(dst, srcBox, offset, size);
+    }
+
     /*reset this object und set all values to initial state*/
     void reset()
     {
@@ -218,16 +309,19 @@ private:
         if (filteredData != nullptr)
             delete[] filteredData;
         filteredData = nullptr;
-        if (fullData != nullptr)
-            delete[] fullData;
-        fullData = nullptr;
         if (isMPICommInitialized)
             MPI_CHECK(MPI_Comm_free(&comm));
         isMPICommInitialized = false;
     }
 
+    static constexpr int tileTag = 1;
+
     char* filteredData;
-    char* fullData;
+    /* buffers reused between the calls */
+    std::vector<char> compressedTile;
+    std::vector<char> recvBuffer;
+    std::vector<char> tileBuffer;
+    std::vector<TileInfo> tiles;
     MPI_Comm comm;
     int mpiRank;
     int numRanks;
@@ -29,6 +29,9 @@
 #include "compileTime/conversion/RemoveFromSeq.hpp"
 #include "dataManagement/DataConnector.hpp"
 #include "traits/Resolve.hpp"
+#include "algorithms/ForEach.hpp"
+#include "forward.hpp"
+#include "dimensions/DataSpaceOperations.hpp"
 
 #include <boost/mpl/vector.hpp>
 #include <boost/mpl/pair.hpp>
@@ -39,6 +42,8 @@
 #include <boost/mpl/find.hpp>
 #include <boost/type_traits.hpp>
 
+#include <vector>
+
 
 namespace picongpu
 {
@@ -165,6 +170,132 @@ struct FreeHostMemory
     }
 };
 
+/** move selected elements of an attribute to the front
+ *
+ * The element `keepIdx[i]` is copied to index `i`, the indices must be
+ * sorted ascending so that the compaction can be done in place.
+ */
+template<typename T_Attribute>
+struct CompactMemory
+{
+    template<typename ValueType >
+    HINLINE void operator()(ValueType& value, const std::vector<uint64_t>& keepIdx) const
+    {
+        typedef T_Attribute Attribute;
+        typedef typename PMacc::traits::Resolve<Attribute>::type::type type;
+
+        type* ptr = value.getIdentifier(Attribute()).getPointer();
+        for (size_t i = 0; i < keepIdx.size(); ++i)
+            ptr[i] = ptr[keepIdx[i]];
+    }
+};
+
+/** remove all particles outside of a cell range from a host frame
+ *
+ * Used for restarts with a changed domain decomposition where the particles
+ * of all overlapping file patches are loaded.
+ *
+ * @param frame frame with the attribute `totalCellIdx` and all particles
+ * @param numParticles number of particles in the frame
+ * @param cellOffset first cell of the range (same origin as `totalCellIdx`)
+ * @param cellExtent number of cells of the range
+ * @return number of particles kept, they are stored at the front of the frame
+ */
+template<typename T_Frame>
+HINLINE uint64_t keepParticlesInCellRange(
+    T_Frame& frame,
+    const uint64_t numParticles,
+    const DataSpace<simDim>& cellOffset,
+    const DataSpace<simDim>& cellExtent)
+{
+    const DataSpace<simDim>* cellIdx = frame.getIdentifier(totalCellIdx()).getPointer();
+
+    std::vector<uint64_t> keepIdx;
+    keepIdx.reserve(numParticles);
+    for (uint64_t i = 0; i < numParticles; ++i)
+    {
+        const DataSpace<simDim> relativeIdx(cellIdx[i] - cellOffset);
+        bool isInside = true;
+        for (uint32_t d = 0; d < simDim; ++d)
+            if (relativeIdx[d] < 0 || relativeIdx[d] >= cellExtent[d])
+                isInside = false;
+        if (isInside)
+            keepIdx.push_back(i);
+    }
+
+    ForEach<typename T_Frame::ValueTypeSeq, CompactMemory<bmpl::_1> > compactMem;
+    compactMem(forward(frame), keepIdx);
+    return keepIdx.size();
+}
+
+/** reorder the elements of an attribute
+ *
+ * The element `srcIdx[i]` is copied to index `i`, `srcIdx` must be a
+ * permutation of all elements.
+ */
+template<typename T_Attribute>
+struct PermuteMemory
+{
+    template<typename ValueType >
+    HINLINE void operator()(ValueType& value, const std::vector<uint64_t>& srcIdx) const
+    {
+        typedef T_Attribute Attribute;
+        typedef typename PMacc::traits::Resolve<Attribute>::type::type type;
+
+        type* ptr = value.getIdentifier(Attribute()).getPointer();
+        const std::vector<type> tmp(ptr, ptr + srcIdx.size());
+        for (size_t i = 0; i < srcIdx.size(); ++i)
+            ptr[i] = tmp[srcIdx[i]];
+    }
+};
+
+/** sort the particles of a host frame by super cell
+ *
+ * The sort is stable, particles of one super cell keep their order.
+ *
+ * @param frame frame with the attribute `totalCellIdx` and all particles
+ * @param numParticles number of particles in the frame
+ * @param firstSuperCell index of the first super cell of the range
+ *                       (`totalCellIdx` divided by the super cell size)
+ * @param numSuperCells number of super cells of the range, all particles
+ *                      must be inside of the range
+ * @return number of particles per super cell, linear index of the range
+ */
+template<typename T_Frame>
+HINLINE std::vector<uint64_t> sortParticlesBySuperCell(
+    T_Frame& frame,
+    const uint64_t numParticles,
+    const DataSpace<simDim>& firstSuperCell,
+    const DataSpace<simDim>& numSuperCells)
+{
+    const DataSpace<simDim>* cellIdx = frame.getIdentifier(totalCellIdx()).getPointer();
+    const DataSpace<simDim> superCellSize(SuperCellSize::toRT());
+
+    std::vector<uint64_t> counts(numSuperCells.productOfComponents(), 0);
+    std::vector<uint64_t> superCellIdx(numParticles);
+    for (uint64_t i = 0; i < numParticles; ++i)
+    {
+        superCellIdx[i] = DataSpaceOperations<simDim>::map(
+            numSuperCells,
+            DataSpace<simDim>(cellIdx[i] / superCellSize - firstSuperCell)
+        );
+        ++counts[superCellIdx[i]];
+    }
+
+    /* counting sort: first destination index of each super cell */
+    std::vector<uint64_t> destIdx(counts.size(), 0);
+    for (size_t s = 1; s < counts.size(); ++s)
+        destIdx[s] = destIdx[s - 1] + counts[s - 1];
+
+    std::vector<uint64_t> srcIdx(numParticles);
+    for (uint64_t i = 0; i < numParticles; ++i)
+        srcIdx[destIdx[superCellIdx[i]]++] = i;
+
+    ForEach<typename T_Frame::ValueTypeSeq, PermuteMemory<bmpl::_1> > permuteMem;
+    permuteMem(forward(frame), srcIdx);
+    return counts;
+}
+
 /*functor to create a pair for a MapTuple map*/
 struct OperatorCreateVectorBox
 {
@@ -56,6 +56,40 @@ public:
         return compressedBytes;
     }
 
+    /** compress into a buffer of limited size
+     *
+     * @param out destination buffer
+     * @param sizeOut size of the destination buffer in bytes
+     * @param in source buffer
+     * @param sizeIn number of bytes to compress
+     * @param compressLevel zlib compression level
+     * @return number of compressed bytes, 0 if the result does not fit into out
+     */
+    size_t compress(void* out, size_t sizeOut, void* in, size_t sizeIn, int compressLevel)
+    {
+        z_stream strm;
+
+        strm.zalloc = Z_NULL;
+        strm.zfree = Z_NULL;
+        strm.opaque = Z_NULL;
+        if (deflateInit(&strm, compressLevel) != Z_OK)
+            return 0;
+
+        strm.avail_in = sizeIn;
+        strm.next_in = (Bytef*) in;
+
+        strm.avail_out = sizeOut;
+        strm.next_out = (Bytef*) out;
+
+        const int ret = deflate(&strm, Z_FINISH);
+        PMACC_ASSERT(ret != Z_STREAM_ERROR);
+
+        const size_t compressedBytes = ret == Z_STREAM_END ? strm.total_out : 0;
+
+        (void) deflateEnd(&strm);
+        return compressedBytes;
+    }
+
     size_t decompress(void* out, void* in, size_t sizeIn,size_t sizeOut)
     {
         int ret;
@@ -25,11 +25,14 @@
 #include "memory/boxes/DataBox.hpp"
 #include "plugins/output/header/MessageHeader.hpp"
 #include "verify.hpp"
+#include "plugins/output/images/PngStripeWriter.hpp"
 
 #include <string>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <memory>
 #include <boost/core/ignore_unused.hpp>
 
 #if( PIC_ENABLE_PNG == 1 )
@@ -56,23 +59,6 @@ namespace picongpu
         step << std::setw( 6 ) << std::setfill( '0' ) << header.sim.step;
         std::string filename( m_name + "_" + step.str( ) + ".png" );
 
-        pngwriter png( size.x( ), size.y( ), 0, filename.c_str( ) );
-
-        /* default compression: 6
-         * zlib level 1 is ~12% bigger but ~2.3x faster in write_png( )
-         */
-        png.setcompressionlevel( 1 );
-
-        //PngWriter coordinate system begin with 1,1
-        for( int y = 0; y < size.y( ); ++y)
-        {
-            for( int x = 0; x < size.x( ); ++x )
-            {
-                float3_X p = data[ y ][ x ];
-                png.plot( x + 1, size.y( ) - y, p.x( ), p.y( ), p.z( ) );
-            }
-        }
-
         /* scale the image by a user defined relative factor
          * `scale_image` is defined in `visualization.param`
          */
@@ -87,29 +73,87 @@ namespace picongpu
             scale_y *= header.sim.scale[ 1 ];
         }
 
+        /* same mapping of [0.0;1.0] to 16 bit as in PNGwriter */
+        auto toColor = []( float_X const value ) -> uint16_t
+        {
+            return uint16_t( std::min( std::max( int( value * float_X( 65535.0 ) ), 0 ), 65535 ) );
+        };
+
         /* to prevent artifacts scale only, if at least one of scale_x and
          * scale_y is != 1.0
          */
+        std::unique_ptr< PngStripeWriter > image;
         if( ( scale_x != float_X( 1.0 ) ) ||
             ( scale_y != float_X( 1.0 ) )
         )
+        {
+            /* PNGwriter is only used for the interpolation, the image
+             * is never written by PNGwriter
+             */
+            pngwriter png( size.x( ), size.y( ), 0, filename.c_str( ) );
+
+            //PngWriter coordinate system begin with 1,1
+            for( int y = 0; y < size.y( ); ++y)
+            {
+                for( int x = 0; x < size.x( ); ++x )
+                {
+                    float3_X p = data[ y ][ x ];
+                    png.plot( x + 1, size.y( ) - y, p.x( ), p.y( ), p.z( ) );
+                }
+            }
+
             //process the cell size and by factor scaling within one step
             png.scale_kxky( scale_x, scale_y );
 
+            int const width = png.getwidth( );
+            int const height = png.getheight( );
+            image.reset( new PngStripeWriter( width, height ) );
+            for( int y = 0; y < height; ++y )
+                for( int x = 0; x < width; ++x )
+                    image->setPixel(
+                        x,
+                        height - 1 - y,
+                        png.read( x + 1, y + 1, 1 ),
+                        png.read( x + 1, y + 1, 2 ),
+                        png.read( x + 1, y + 1, 3 )
+                    );
+        }
+        else
+        {
+            image.reset( new PngStripeWriter( size.x( ), size.y( ) ) );
+            /* the first image row is the upper border of the simulation */
+            for( int y = 0; y < size.y( ); ++y )
+            {
+                for( int x = 0; x < size.x( ); ++x )
+                {
+                    float3_X p = data[ y ][ x ];
+                    image->setPixel(
+                        x,
+                        size.y( ) - 1 - y,
+                        toColor( p.x( ) ),
+                        toColor( p.y( ) ),
+                        toColor( p.z( ) )
+                    );
+                }
+            }
+        }
+
         // add some meta information
         //header.writeToConsole( std::cout );
 
         std::ostringstream description( std::ostringstream::out );
         header.writeToConsole( description );
 
-        char title[ ] = "PIConGPU preview image";
-        std::string author = Environment<>::get().SimulationDescription().getAuthor( );
-        char software[ ] = "PIConGPU with PNGwriter";
+        image->addText( "Title", "PIConGPU preview image" );
+        image->addText( "Author", Environment<>::get().SimulationDescription().getAuthor( ) );
+        image->addText( "Description", description.str( ) );
+        image->addText( "Software", "PIConGPU with PNGwriter" );
 
-        png.settext( title, author.c_str( ), description.str( ).c_str( ), software );
-
-        // write to disk and close object
-        png.close( );
+        /* default compression: 6
+         * zlib level 1 is ~12% bigger but ~2.3x faster,
+         * the row stripes are compressed in parallel
+         */
+        image->write( filename, 1 );
 #else
         boost::ignore_unused( data, size, header );
         /* always fail with an exception at runtime */
@@ -0,0 +1,291 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of PIConGPU.
+ *
+ * PIConGPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * PIConGPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PIConGPU.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "verify.hpp"
+
+#include <boost/thread.hpp>
+
+#include <zlib.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <exception>
+#include <stdint.h>
+
+
+namespace picongpu
+{
+
+    /** PNG writer with parallel compression
+     *
+     * The image (16 bit RGB) is split into row stripes which are deflated
+     * by independent threads. All stripes except the last one end with a
+     * sync flush (byte aligned, not final), therefore the concatenation of
+     * the stripes is one valid zlib stream (like pigz). The adler32
+     * checksums of the stripes are combined, each stripe is written as
+     * its own IDAT chunk.
+     */
+    class PngStripeWriter
+    {
+    public:
+
+        /** constructor
+         *
+         * @param width width of the image in pixels
+         * @param height height of the image in pixels
+         */
+        PngStripeWriter( uint32_t const width, uint32_t const height ) :
+            m_width( width ),
+            m_height( height ),
+            m_rowBytes( 1u + width * bytesPerPixel ),
+            m_rows( size_t( m_rowBytes ) * height, 0u )
+        {
+        }
+
+        /** set the color of a pixel
+         *
+         * @param x column, range [0;width)
+         * @param y row, range [0;height), row 0 is the top row
+         * @param red red channel, range [0;65535]
+         * @param green green channel, range [0;65535]
+         * @param blue blue channel, range [0;65535]
+         */
+        void setPixel(
+            uint32_t const x,
+            uint32_t const y,
+            uint16_t const red,
+            uint16_t const green,
+            uint16_t const blue
+        )
+        {
+            /* the first byte of each row is the filter type (0: none) */
+            uint8_t* pixel = &m_rows[ size_t( y ) * m_rowBytes + 1u + x * bytesPerPixel ];
+            pixel[ 0 ] = uint8_t( red >> 8 );
+            pixel[ 1 ] = uint8_t( red );
+            pixel[ 2 ] = uint8_t( green >> 8 );
+            pixel[ 3 ] = uint8_t( green );
+            pixel[ 4 ] = uint8_t( blue >> 8 );
+            pixel[ 5 ] = uint8_t( blue );
+        }
+
+        /** add a text chunk
+         *
+         * @param key keyword, e.g. "Title", "Author", "Description", "Software"
+         * @param value Latin-1 text
+         */
+        void addText( std::string const & key, std::string const & value )
+        {
+            m_texts.push_back( std::make_pair( key, value ) );
+        }
+
+        /** compress and write the image
+         *
+         * @param filename name of the output file
+         * @param compressionLevel zlib compression level
+         * @param numThreads maximum number of compression threads, 0 selects
+         *                   the number of hardware threads
+         */
+        void write(
+            std::string const & filename,
+            int const compressionLevel,
+            uint32_t numThreads = 0u
+        ) const
+        {
+            if( numThreads == 0u )
+                numThreads = std::max( boost::thread::hardware_concurrency( ), 1u );
+            /* a stripe should be large enough to keep the compression ratio */
+            uint32_t const minRowsPerStripe = std::max( ( 64u * 1024u ) / m_rowBytes, 1u );
+            uint32_t const numStripes = std::max(
+                std::min( numThreads, m_height / minRowsPerStripe ),
+                1u
+            );
+            uint32_t const rowsPerStripe = ( m_height + numStripes - 1u ) / numStripes;
+
+            std::vector< Stripe > stripes( numStripes );
+            boost::thread_group threads;
+            for( uint32_t i = 0; i < numStripes; ++i )
+            {
+                uint32_t const firstRow = std::min( i * rowsPerStripe, m_height );
+                uint32_t const lastRow = std::min( firstRow + rowsPerStripe, m_height );
+                Stripe & stripe = stripes[ i ];
+                bool const isLast = i + 1u == numStripes;
+                threads.create_thread(
+                    [ this, &stripe, firstRow, lastRow, compressionLevel, isLast ]( )
+                    {
+                        /* an exception leaving the thread terminates the program */
+                        try
+                        {
+                            this->compressStripe( stripe, firstRow, lastRow, compressionLevel, isLast );
+                        }
+                        catch( ... )
+                        {
+                            stripe.error = std::current_exception( );
+                        }
+                    }
+                );
+            }
+            threads.join_all( );
+
+            for( uint32_t i = 0; i < numStripes; ++i )
+                if( stripes[ i ].error )
+                    std::rethrow_exception( stripes[ i ].error );
+
+            std::ofstream file( filename.c_str( ), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc );
+            PMACC_VERIFY_MSG( file.good( ), std::string( "can not open file " ) + filename );
+
+            static uint8_t const signature[ ] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+            file.write( reinterpret_cast< char const * >( signature ), sizeof( signature ) );
+
+            std::vector< uint8_t > header;
+            appendUInt32( header, m_width );
+            appendUInt32( header, m_height );
+            header.push_back( 16u ); /* bit depth */
+            header.push_back( 2u );  /* color type: RGB */
+            header.push_back( 0u );  /* compression method: deflate */
+            header.push_back( 0u );  /* filter method */
+            header.push_back( 0u );  /* no interlace */
+            writeChunk( file, "IHDR", header );
+
+            for( size_t i = 0; i < m_texts.size( ); ++i )
+            {
+                std::vector< uint8_t > text( m_texts[ i ].first.begin( ), m_texts[ i ].first.end( ) );
+                text.push_back( 0u );
+                text.insert( text.end( ), m_texts[ i ].second.begin( ), m_texts[ i ].second.end( ) );
+                writeChunk( file, "tEXt", text );
+            }
+
+            /* zlib stream: header, stripes, adler32 of the uncompressed data */
+            uLong adler = adler32( 0L, Z_NULL, 0 );
+            for( uint32_t i = 0; i < numStripes; ++i )
+            {
+                std::vector< uint8_t > idat;
+                if( i == 0u )
+                {
+                    /* deflate with 32K window, check bits such that the header is a multiple of 31 */
+                    idat.push_back( 0x78 );
+                    idat.push_back( 0x01 );
+                }
+                idat.insert( idat.end( ), stripes[ i ].data.begin( ), stripes[ i ].data.end( ) );
+                adler = adler32_combine( adler, stripes[ i ].adler, stripes[ i ].inputBytes );
+                if( i + 1u == numStripes )
+                    appendUInt32( idat, uint32_t( adler ) );
+                writeChunk( file, "IDAT", idat );
+            }
+
+            writeChunk( file, "IEND", std::vector< uint8_t >( ) );
+            PMACC_VERIFY_MSG( file.good( ), std::string( "error while writing file " ) + filename );
+        }
+
+    private:
+
+        static constexpr uint32_t bytesPerPixel = 6u;
+
+        /** compressed part of the image */
+        struct Stripe
+        {
+            std::vector< uint8_t > data;
+            uLong adler;
+            z_off_t inputBytes;
+            /* exception thrown by the compression thread */
+            std::exception_ptr error;
+        };
+
+        /** deflate the rows [firstRow;lastRow) as raw deflate data */
+        void compressStripe(
+            Stripe & stripe,
+            uint32_t const firstRow,
+            uint32_t const lastRow,
+            int const compressionLevel,
+            bool const isLast
+        ) const
+        {
+            uint8_t const * input = m_rows.empty( ) ? nullptr : &m_rows[ size_t( firstRow ) * m_rowBytes ];
+            size_t const inputBytes = size_t( lastRow - firstRow ) * m_rowBytes;
+
+            stripe.inputBytes = z_off_t( inputBytes );
+            stripe.adler = adler32( adler32( 0L, Z_NULL, 0 ), input, uInt( inputBytes ) );
+
+            z_stream strm;
+            strm.zalloc = Z_NULL;
+            strm.zfree = Z_NULL;
+            strm.opaque = Z_NULL;
+            /* negative window bits: raw deflate without zlib header and checksum */
+            if( deflateInit2( &strm, compressionLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+                throw std::runtime_error( "PngStripeWriter: deflateInit2 failed" );
+
+            /* additional bytes for the flush marker */
+            stripe.data.resize( deflateBound( &strm, uLong( inputBytes ) ) + 16u );
+            strm.next_in = const_cast< Bytef* >( input );
+            strm.avail_in = uInt( inputBytes );
+            strm.next_out = &stripe.data[ 0 ];
+            strm.avail_out = uInt( stripe.data.size( ) );
+
+            int const ret = deflate( &strm, isLast ? Z_FINISH : Z_SYNC_FLUSH );
+            bool const isComplete = isLast ? ret == Z_STREAM_END : ( ret == Z_OK && strm.avail_out != 0u );
+            stripe.data.resize( strm.total_out );
+            deflateEnd( &strm );
+            if( !isComplete )
+                throw std::runtime_error( "PngStripeWriter: deflate failed" );
+        }
+
+        static void appendUInt32( std::vector< uint8_t > & buffer, uint32_t const value )
+        {
+            buffer.push_back( uint8_t( value >> 24 ) );
+            buffer.push_back( uint8_t( value >> 16 ) );
+            buffer.push_back( uint8_t( value >> 8 ) );
+            buffer.push_back( uint8_t( value ) );
+        }
+
+        static void writeChunk(
+            std::ofstream & file,
+            char const * type,
+            std::vector< uint8_t > const & data
+        )
+        {
+            std::vector< uint8_t > length;
+            appendUInt32( length, uint32_t( data.size( ) ) );
+            file.write( reinterpret_cast< char const * >( &length[ 0 ] ), 4 );
+            file.write( type, 4 );
+            uLong crc = crc32( 0L, Z_NULL, 0 );
+            crc = crc32( crc, reinterpret_cast< Bytef const * >( type ), 4 );
+            if( !data.empty( ) )
+            {
+                file.write( reinterpret_cast< char const * >( &data[ 0 ] ), data.size( ) );
+                crc = crc32( crc, &data[ 0 ], uInt( data.size( ) ) );
+            }
+            std::vector< uint8_t > checksum;
+            appendUInt32( checksum, uint32_t( crc ) );
+            file.write( reinterpret_cast< char const * >( &checksum[ 0 ] ), 4 );
+        }
+
+        uint32_t m_width;
+        uint32_t m_height;
+        uint32_t m_rowBytes;
+        /* filter byte and pixels of all rows */
+        std::vector< uint8_t > m_rows;
+        std::vector< std::pair< std::string, std::string > > m_texts;
+    };
+
+} /* namespace picongpu */
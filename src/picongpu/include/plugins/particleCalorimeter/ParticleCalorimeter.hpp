@@ -203,6 +203,11 @@ private:
                            &(*hBufTotal.origin()));
 
         hdf5DataFile.close();
+
+        /* libSplash appends the position of the serial writer to the name */
+        std::stringstream checkpointFile;
+        checkpointFile << prefix << "_" << currentStep << "_0_0_0.h5";
+        this->addCheckpointFile(checkpointFile.str());
     }
 
 
@@ -24,14 +24,37 @@
 #include "math/Vector.hpp"
 #include "algorithms/math.hpp"
 #include "memory/shared/Allocate.hpp"
+#include "algorithms/Histogram.hpp"
 
 namespace picongpu
 {
 using namespace PMacc;
 
+/** add a value to a bin of the calorimeter
+ *
+ * The linear bin index is `(energyBin * numBinsPitch + pitchBin) * numBinsYaw + yawBin`.
+ */
+template<typename CalorimeterCur>
+struct CalorimeterAddToBin
+{
+    CalorimeterCur calorimeterCur;
+    uint32_t numBinsYaw;
+    uint32_t numBinsPitch;
+
+    DINLINE void operator()(const int bin, const float_X value) const
+    {
+        const int yawBin = bin % numBinsYaw;
+        const int pitchBin = (bin / numBinsYaw) % numBinsPitch;
+        const int energyBin = bin / (numBinsYaw * numBinsPitch);
+        atomicAddWrapper(&(*calorimeterCur(yawBin, pitchBin, energyBin)), value);
+    }
+};
+
 template<typename CalorimeterCur>
 struct CalorimeterFunctor
 {
+    typedef CalorimeterAddToBin<CalorimeterCur> AddToBin;
+
     CalorimeterCur calorimeterCur;
 
     const float_X maxYaw;
@@ -79,8 +102,22 @@ struct CalorimeterFunctor
         this->calorimeterCur = calorimeterCur;
     }
 
+    /** functor adding to the calorimeter, sink of the BinCache */
+    HDINLINE AddToBin getAddToBin() const
+    {
+        const AddToBin addToBin = {calorimeterCur, numBinsYaw, numBinsPitch};
+        return addToBin;
+    }
+
+    /** bin a particle
+     *
+     * @param binCache cache of the calling thread, consecutive particles of
+     *                 the thread in the same bin are added together,
+     *                 must be flushed with getAddToBin() after the last particle
+     */
     template<typename ParticlesFrame>
-    DINLINE void operator()(ParticlesFrame& particlesFrame, const uint32_t linearThreadIdx)
+    DINLINE void operator()(ParticlesFrame& particlesFrame, const uint32_t linearThreadIdx,
+                            algorithms::histogram::BinCache<float_X>& binCache)
     {
         const float3_X mom = particlesFrame[linearThreadIdx][momentum_];
         const float_X mom2 = math::dot(mom, mom);
@@ -136,8 +173,9 @@ struct CalorimeterFunctor
                 energyBin = energyBin > 0 ? energyBin : 0;
             }
 
-            atomicAddWrapper(&(*this->calorimeterCur(yawBin, pitchBin, energyBin)),
-                             energy * normedWeighting);
+            binCache.add((energyBin * numBinsPitch + pitchBin) * numBinsYaw + yawBin,
+                         energy * normedWeighting,
+                         getAddToBin());
         }
     }
 };
@@ -191,6 +229,7 @@ struct ParticleCalorimeterKernel
 
         __syncthreads();
 
+        algorithms::histogram::BinCache<float_X> binCache;
         while(particlesFrame.isValid())
         {
             /* casting uint8_t multiMask to boolean */
@@ -198,7 +237,7 @@ struct ParticleCalorimeterKernel
 
             if(isParticle)
             {
-                calorimeterFunctor(particlesFrame, linearThreadIdx);
+                calorimeterFunctor(particlesFrame, linearThreadIdx, binCache);
             }
 
             __syncthreads();
@@ -209,6 +248,7 @@ struct ParticleCalorimeterKernel
             }
             __syncthreads();
         }
+        binCache.flush(calorimeterFunctor.getAddToBin());
     }
 };
 
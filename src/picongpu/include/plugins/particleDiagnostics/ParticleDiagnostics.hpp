@@ -0,0 +1,355 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of PIConGPU.
+ *
+ * PIConGPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * PIConGPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PIConGPU.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "simulation_defines.hpp"
+#include "plugins/particleDiagnostics/ParticleDiagnostics.kernel"
+
+#include "mappings/kernel/AreaMapping.hpp"
+#include "memory/buffers/GridBuffer.hpp"
+#include "dataManagement/DataConnector.hpp"
+#include "mpi/reduceMethods/Reduce.hpp"
+#include "mpi/MPIReduce.hpp"
+#include "nvidia/functors/Add.hpp"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace picongpu
+{
+namespace particleDiagnostics
+{
+    using namespace PMacc;
+
+    /** accumulators of the fused particle diagnostics */
+    enum Accumulator
+    {
+        COUNT = 0,
+        ENERGY = 1,
+        HISTOGRAM = 2,
+        NUM_ACCUMULATORS = 3
+    };
+
+    /** fused particle reductions of one species
+     *
+     * Plugins register the accumulators they need together with their
+     * notification period in pluginLoad(). The first plugin requesting a
+     * result within a step starts one kernel sweeping all frames of the
+     * species for all accumulators due in this step, followed by one packed
+     * non-blocking MPI reduction. All other plugins of this step use the
+     * result of the same reduction.
+     *
+     * Results are delivered to callbacks (requestResult()) as soon as the
+     * event system finished the reduction, therefore the simulation
+     * continues while the reduction is in flight.
+     *
+     * @tparam T_Species particle species
+     */
+    template<class T_Species>
+    class ParticleDiagnostics
+    {
+    public:
+
+        /* shared memory for the histogram copies of one block, the kernel
+         * still needs one copy if the histogram exceeds this size
+         */
+        static constexpr size_t maxHistogramSharedMemory = 16 * 1024;
+
+        static ParticleDiagnostics& getInstance()
+        {
+            static ParticleDiagnostics instance;
+            return instance;
+        }
+
+        /** register a user of an accumulator
+         *
+         * @param accumulator requested accumulator
+         * @param period notification period of the user
+         */
+        void addUser(Accumulator const accumulator, uint32_t const period)
+        {
+            /* the communicator must be freed before MPI is finalized, therefore
+             * it lives only as long as the engine has users
+             */
+            if (reduce == nullptr)
+                reduce = new mpi::MPIReduce();
+            periods[accumulator].push_back(period);
+        }
+
+        /** remove a user, the memory is freed with the last user
+         *
+         * Finishes the reduction in flight, call it on all ranks.
+         */
+        void removeUser(Accumulator const accumulator)
+        {
+            wait();
+            if (!periods[accumulator].empty())
+                periods[accumulator].pop_back();
+
+            for (uint32_t i = 0; i < NUM_ACCUMULATORS; ++i)
+                if (!periods[i].empty())
+                    return;
+            __delete(gResult);
+            __delete(reduce);
+            cachedStep = -1;
+        }
+
+        /** set the histogram range and detector
+         *
+         * @param numberOfBins number of bins between minimum and maximum energy
+         * @param minEnergy minimum energy in PIConGPU units
+         * @param maxEnergy maximum energy in PIConGPU units
+         * @param maximumSlopeToDetectorX maximum slope p_x/p_y to count a particle, zero disables the detector
+         * @param maximumSlopeToDetectorZ maximum slope p_z/p_y to count a particle, zero disables the detector
+         */
+        void setHistogram(
+            int const numberOfBins,
+            float_X const minEnergy,
+            float_X const maxEnergy,
+            float_X const maximumSlopeToDetectorX,
+            float_X const maximumSlopeToDetectorZ
+        )
+        {
+            if (gResult != nullptr)
+                throw std::runtime_error("ParticleDiagnostics: histogram can not be changed after the first sweep");
+            numBins = numberOfBins;
+            param.minEnergy = minEnergy;
+            param.maxEnergy = maxEnergy;
+            param.maximumSlopeToDetectorX = maximumSlopeToDetectorX;
+            param.maximumSlopeToDetectorZ = maximumSlopeToDetectorZ;
+        }
+
+        void setMappingDescription(MappingDesc* description)
+        {
+            cellDescription = description;
+        }
+
+        /** true if this rank holds the reduced results, call after addUser() */
+        bool hasResult()
+        {
+            return reduce->hasResult(mpi::reduceMethods::Reduce());
+        }
+
+        /** request the values of an accumulator reduced over all ranks
+         *
+         * Must be called by all ranks. The callback is called on all ranks
+         * after the reduction is finished, within this call or later from the
+         * event system, at the latest with the next sweep or wait().
+         *
+         * @param accumulator requested accumulator
+         * @param currentStep current simulation step
+         * @param callback functor with the signature `void(float_64 const * result)`,
+         *                 result is nullptr if hasResult() is false and only
+         *                 valid during the call, @see getResult() for the layout
+         */
+        void requestResult(
+            Accumulator const accumulator,
+            uint32_t const currentStep,
+            std::function<void(float_64 const *)> const & callback
+        )
+        {
+            update(accumulator, currentStep);
+            if (reducedStep == cachedStep)
+                /* reduction of this step is already finished */
+                callback(hasResult() ? &reducedResult[offset(accumulator)] : nullptr);
+            else
+                callbacks.push_back(std::make_pair(accumulator, callback));
+        }
+
+        /** finish the reduction in flight and call all pending callbacks
+         *
+         * Must be called by all ranks, e.g. before a checkpoint is written.
+         */
+        void wait()
+        {
+            pendingReduce.waitForFinished();
+        }
+
+        /** get the values of an accumulator reduced over all ranks
+         *
+         * Must be called by all ranks, blocks until the reduction is finished.
+         * The result is only valid if hasResult() is true. The pointer is valid
+         * until the next sweep.
+         *
+         * @param accumulator requested accumulator
+         * @param currentStep current simulation step
+         * @return count: one value, energy: kinetic and total energy,
+         *         histogram: numBins + 2 bins with weightings normed to
+         *         TYPICAL_NUM_PARTICLES_PER_MACROPARTICLE
+         */
+        float_64 const * getResult(Accumulator const accumulator, uint32_t const currentStep)
+        {
+            update(accumulator, currentStep);
+            wait();
+            return &reducedResult[offset(accumulator)];
+        }
+
+        /** get the values of an accumulator of this rank, @see getResult() */
+        float_64 const * getLocalResult(Accumulator const accumulator, uint32_t const currentStep)
+        {
+            update(accumulator, currentStep);
+            return gResult->getHostBuffer().getBasePointer() + offset(accumulator);
+        }
+
+    private:
+
+        ParticleDiagnostics() :
+            gResult(nullptr), cellDescription(nullptr), numBins(0), cachedStep(-1), reducedStep(-1),
+            reduce(nullptr)
+        {
+            param.withEnergy = false;
+            param.numBins = 0;
+            param.numHistogramCopies = 1;
+            param.minEnergy = float_X(0.0);
+            param.maxEnergy = float_X(0.0);
+            param.maximumSlopeToDetectorX = float_X(0.0);
+            param.maximumSlopeToDetectorZ = float_X(0.0);
+            for (uint32_t i = 0; i < NUM_ACCUMULATORS; ++i)
+                isCached[i] = false;
+        }
+
+        ParticleDiagnostics(ParticleDiagnostics const &);
+
+        static uint32_t offset(Accumulator const accumulator)
+        {
+            return accumulator == COUNT ? ResultIdx::count :
+                accumulator == ENERGY ? ResultIdx::energyKin : ResultIdx::histogram;
+        }
+
+        /** number of private histogram copies per block
+         *
+         * As many copies as fit into maxHistogramSharedMemory, at most one per warp.
+         */
+        static int getNumHistogramCopies(int const realNumBins)
+        {
+            const int numWarps = PMacc::math::CT::volume<MappingDesc::SuperCellSize>::type::value / 32;
+            int numCopies = 1;
+            while (
+                numCopies < numWarps &&
+                sizeof(float_X) * algorithms::histogram::PrivatizedHistogram<float_X>::getSize(realNumBins, numCopies + 1) <=
+                    maxHistogramSharedMemory
+            )
+                ++numCopies;
+            return numCopies;
+        }
+
+        /** true if any user of the accumulator is notified in this step */
+        bool isDue(uint32_t const accumulator, uint32_t const currentStep) const
+        {
+            for (size_t i = 0; i < periods[accumulator].size(); ++i)
+                if (periods[accumulator][i] != 0 && currentStep % periods[accumulator][i] == 0)
+                    return true;
+            return false;
+        }
+
+        /** sweep and reduce if the accumulator is not cached for this step */
+        void update(Accumulator const accumulator, uint32_t const currentStep)
+        {
+            if (cachedStep == int64_t(currentStep) && isCached[accumulator])
+                return;
+
+            /* the previous reduction delivers its results before it is overwritten */
+            wait();
+
+            /* all accumulators due in this step are computed together */
+            for (uint32_t i = 0; i < NUM_ACCUMULATORS; ++i)
+                isCached[i] = (i == uint32_t(accumulator)) || isDue(i, currentStep);
+            cachedStep = currentStep;
+
+            param.withEnergy = isCached[ENERGY];
+            param.numBins = isCached[HISTOGRAM] ? numBins : 0;
+            const int realNumBins = param.numBins > 0 ? param.numBins + 2 : 0;
+            param.numHistogramCopies = getNumHistogramCopies(realNumBins);
+            const size_t histogramSize = sizeof(float_X) *
+                algorithms::histogram::PrivatizedHistogram<float_X>::getSize(realNumBins, param.numHistogramCopies);
+
+            if (gResult == nullptr)
+            {
+                const size_t numValues = ResultIdx::histogram + (numBins > 0 ? numBins + 2 : 0);
+                gResult = new GridBuffer<float_64, DIM1>(DataSpace<DIM1>(numValues));
+                reducedResult.resize(numValues);
+            }
+            gResult->getDeviceBuffer().setValue(0.0);
+
+            DataConnector &dc = Environment<>::get().DataConnector();
+            auto particles = dc.get< T_Species >( T_Species::FrameType::getName(), true );
+
+            AreaMapping<CORE + BORDER, MappingDesc> mapper(*cellDescription);
+            PMACC_KERNEL(KernelParticleDiagnostics{})
+                (mapper.getGridDim(), MappingDesc::SuperCellSize::toRT(), histogramSize)
+                (particles->getDeviceParticlesBox(),
+                 gResult->getDeviceBuffer().getDataBox(),
+                 param,
+                 mapper);
+
+            dc.releaseData( T_Species::FrameType::getName() );
+            gResult->deviceToHost();
+
+            /* one reduction for all accumulators */
+            const size_t numValues = ResultIdx::histogram + realNumBins;
+            const int64_t step = cachedStep;
+            pendingReduce = reduce->async(
+                nvidia::functors::Add(),
+                gResult->getHostBuffer().getBasePointer(),
+                numValues,
+                mpi::reduceMethods::Reduce(),
+                [this, step, numValues](float_64 const * result)
+                {
+                    this->finishReduce(step, result, numValues);
+                }
+            );
+        }
+
+        /** store the reduced values and notify the waiting users */
+        void finishReduce(int64_t const step, float_64 const * result, size_t const numValues)
+        {
+            if (result != nullptr)
+                std::copy(result, result + numValues, reducedResult.begin());
+            reducedStep = step;
+
+            std::vector<std::pair<Accumulator, std::function<void(float_64 const *)> > > finished;
+            finished.swap(callbacks);
+            for (size_t i = 0; i < finished.size(); ++i)
+                finished[i].second(result != nullptr ? &reducedResult[offset(finished[i].first)] : nullptr);
+        }
+
+        GridBuffer<float_64, DIM1>* gResult;
+        std::vector<float_64> reducedResult;
+        MappingDesc* cellDescription;
+        /* notification periods of the users of each accumulator */
+        std::vector<uint32_t> periods[NUM_ACCUMULATORS];
+        int numBins;
+        SweepParam param;
+        /* step of the cached result, -1 if nothing is cached */
+        int64_t cachedStep;
+        bool isCached[NUM_ACCUMULATORS];
+        /* step of the values in reducedResult, -1 if no reduction is finished */
+        int64_t reducedStep;
+        /* reduction in flight and its waiting users */
+        EventTask pendingReduce;
+        std::vector<std::pair<Accumulator, std::function<void(float_64 const *)> > > callbacks;
+        mpi::MPIReduce* reduce;
+    };
+
+} // namespace particleDiagnostics
+} // namespace picongpu
@@ -0,0 +1,299 @@
+/* Copyright 2017 Rene Widera
+ *
+ * This file is part of PIConGPU.
+ *
+ * PIConGPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * PIConGPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PIConGPU.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "simulation_defines.hpp"
+
+#include "plugins/radiation/parameters.hpp"
+#include "plugins/radiation/particle.hpp"
+#include "plugins/radiation/amplitude.hpp"
+#include "plugins/radiation/calc_amplitude.hpp"
+#include "plugins/radiation/windowFunctions.hpp"
+#include "plugins/radiation/nyquist_low_pass.hpp"
+#include "plugins/radiation/radFormFactor.hpp"
+
+#include <vector>
+
+
+namespace picongpu
+{
+namespace radiation
+{
+
+    /** precision used to sum the amplitudes of the particles of one frame
+     *
+     * The sum over frames and time steps is always done with Amplitude
+     * (float_64).
+     *
+     * @tparam T_mixedPrecision true: float_32 with Kahan compensation,
+     *                          false: float_64
+     */
+    template< bool T_mixedPrecision >
+    struct AmplitudePrecision
+    {
+        using type = float_32;
+        using VectorType = vector_32;
+        static constexpr bool compensated = true;
+    };
+
+    template< >
+    struct AmplitudePrecision< false >
+    {
+        using type = float_64;
+        using VectorType = vector_64;
+        static constexpr bool compensated = false;
+    };
+
+    /** frequency independent part of the amplitude of one particle
+     *
+     * seen from one observation direction
+     */
+    template< typename T_Precision >
+    struct ParticleAmplitude
+    {
+        using VectorType = typename T_Precision::VectorType;
+
+        /* real vector part of the amplitude including charge, time step
+         * and window function */
+        VectorType realAmplitude;
+        /* retarded time */
+        float_64 t_ret;
+        /* macro particle weighting, used by the form factor */
+        float_X weighting;
+        NyquistLowPass lowpass;
+
+        HDINLINE ParticleAmplitude( )
+        {
+        }
+
+        /** calculate the amplitude of a particle
+         *
+         * @param particle particle (location, momenta and mass)
+         * @param look observation direction
+         * @param t simulation time
+         * @param charge charge of a particle with weighting one
+         * @param particleWeighting macro particle weighting
+         * @param simBoxSize global size of the simulation in cells
+         */
+        HDINLINE ParticleAmplitude(
+            ::Particle const & particle,
+            vector_64 const & look,
+            float_64 const t,
+            float_X const charge,
+            float_X const particleWeighting,
+            DataSpace< simDim > const & simBoxSize
+        ) :
+            weighting( particleWeighting ),
+            lowpass( look, particle )
+        {
+            // set up amplitude calculator
+            typedef Calc_Amplitude< Retarded_time_1, Old_DFT > Calc_Amplitude_n_sim_1;
+            const Calc_Amplitude_n_sim_1 amplitude3( particle, DELTA_T, t );
+
+            /* the particle amplitude is used to include the weighting
+             * of the window function filter without needing more memory */
+            const radWindowFunction::radWindowFunction winFkt;
+            const vector_64 location = particle.get_location< When::now >( );
+            float_X windowFactor = 1.0;
+            for( uint32_t d = 0; d < simDim; ++d )
+                windowFactor *= winFkt( float_X( location[ d ] ), simBoxSize[ d ] * cellSize[ d ] );
+
+            realAmplitude = VectorType(
+                amplitude3.get_vector( look ) *
+                float_64( charge ) *
+                float_64( DELTA_T ) *
+                float_64( windowFactor )
+            );
+            t_ret = amplitude3.get_t_ret( look );
+        }
+    };
+
+    /** sum of the complex amplitudes of particles for one direction and frequency
+     *
+     * In mixed precision the summation error is compensated with the Kahan
+     * algorithm, the phase is reduced to [0;2pi) in float_64 before the
+     * trigonometric functions are evaluated in float_32.
+     */
+    template< typename T_Precision >
+    class AmplitudeSum
+    {
+    public:
+        using float_T = typename T_Precision::type;
+
+        HDINLINE AmplitudeSum( )
+        {
+            for( uint32_t i = 0; i < Amplitude::numComponents; ++i )
+            {
+                sum[ i ] = float_T( 0.0 );
+                compensation[ i ] = float_T( 0.0 );
+            }
+        }
+
+        /** add the contribution of a particle
+         *
+         * @param particle amplitude of the particle for this direction
+         * @param omega frequency
+         * @param look observation direction
+         */
+        HDINLINE void add(
+            ParticleAmplitude< T_Precision > const & particle,
+            float_64 const omega,
+            vector_64 const & look
+        )
+        {
+            // check Nyquist-limit for the particle and the frequency "omega"
+            if( !particle.lowpass.check( omega ) )
+                return;
+
+            // calculate the form factor's influences to the real amplitude
+            const radFormFactor::radFormFactor myRadFormFactor{ };
+            const float_T formFactor = float_T( myRadFormFactor( particle.weighting, omega, look ) );
+
+            add( particle.realAmplitude, formFactor, particle.t_ret * omega );
+        }
+
+        /** add a complex amplitude
+         *
+         * @param realAmplitude real vector part of the amplitude
+         * @param scale factor applied to the real vector part
+         * @param phase complex phase
+         */
+        HDINLINE void add(
+            typename T_Precision::VectorType const & realAmplitude,
+            float_T const scale,
+            float_64 phase
+        )
+        {
+            if( T_Precision::compensated )
+            {
+                const float_64 twoPi = 2.0 * PI;
+                phase -= twoPi * math::floor( phase / twoPi );
+            }
+            float_T sinValue;
+            float_T cosValue;
+            math::sincos( float_T( phase ), sinValue, cosValue );
+
+            for( uint32_t d = 0; d < 3; ++d )
+            {
+                const float_T amplitude = realAmplitude[ d ] * scale;
+                addComponent( 2 * d, amplitude * cosValue );
+                addComponent( 2 * d + 1, amplitude * sinValue );
+            }
+        }
+
+        /** get the sum in double precision
+         *
+         * @param factor factor applied to all components
+         */
+        HDINLINE Amplitude get( float_64 const factor = 1.0 ) const
+        {
+            return Amplitude(
+                factor * sum[ 0 ], factor * sum[ 1 ],
+                factor * sum[ 2 ], factor * sum[ 3 ],
+                factor * sum[ 4 ], factor * sum[ 5 ]
+            );
+        }
+
+    private:
+
+        HDINLINE void addComponent( uint32_t const i, float_T const value )
+        {
+            if( T_Precision::compensated )
+            {
+                const float_T y = value - compensation[ i ];
+                const float_T t = sum[ i ] + y;
+                compensation[ i ] = ( t - sum[ i ] ) - y;
+                sum[ i ] = t;
+            }
+            else
+                sum[ i ] += value;
+        }
+
+        /* Re(x), Im(x), Re(y), Im(y), Re(z), Im(z) */
+        float_T sum[ Amplitude::numComponents ];
+        float_T compensation[ Amplitude::numComponents ];
+    };
+
+    /** calculate the amplitudes of particles on the host
+     *
+     * Evaluates the same amplitude math as KernelRadiationParticles,
+     * parallelized with OpenMP over tiles of directions and frequencies.
+     * Can be used to validate the results of the device or to process
+     * particles on the host.
+     *
+     * @tparam T_Precision precision of the per tile sum, @see AmplitudePrecision
+     * @param particles particles (location, momenta and mass)
+     * @param weightings macro particle weighting of each particle
+     * @param charge charge of a particle with weighting one
+     * @param t simulation time
+     * @param freqFkt frequency functor
+     * @param simBoxSize global size of the simulation in cells
+     * @param result amplitudes with N_observer * N_omega elements,
+     *               the contributions are added
+     */
+    template<
+        typename T_Precision,
+        typename T_FreqFunctor
+    >
+    HINLINE void calculateAmplitudesHost(
+        std::vector< ::Particle > const & particles,
+        std::vector< float_X > const & weightings,
+        float_X const charge,
+        float_64 const t,
+        T_FreqFunctor freqFkt,
+        DataSpace< simDim > const & simBoxSize,
+        Amplitude * result
+    )
+    {
+        constexpr int numDirections = parameters::N_observer;
+        constexpr int numOmegas = radiation_frequencies::N_omega;
+        /* frequencies per tile, a tile shares the particle amplitudes */
+        constexpr int omegaTileSize = 64;
+        constexpr int numOmegaTiles = ( numOmegas + omegaTileSize - 1 ) / omegaTileSize;
+        const int numParticles = particles.size( );
+
+        #pragma omp parallel for schedule(dynamic)
+        for( int tile = 0; tile < numDirections * numOmegaTiles; ++tile )
+        {
+            const int theta_idx = tile / numOmegaTiles;
+            const int firstOmega = ( tile % numOmegaTiles ) * omegaTileSize;
+            const int endOmega = firstOmega + omegaTileSize < numOmegas ? firstOmega + omegaTileSize : numOmegas;
+            const vector_64 look = radiation_observer::observation_direction( theta_idx );
+
+            std::vector< ParticleAmplitude< T_Precision > > amplitudes;
+            amplitudes.reserve( numParticles );
+            for( int j = 0; j < numParticles; ++j )
+                amplitudes.push_back(
+                    ParticleAmplitude< T_Precision >( particles[ j ], look, t, charge, weightings[ j ], simBoxSize )
+                );
+
+            for( int o = firstOmega; o < endOmega; ++o )
+            {
+                const float_64 omega = freqFkt( o );
+                AmplitudeSum< T_Precision > amplitude;
+                for( int j = 0; j < numParticles; ++j )
+                    amplitude.add( amplitudes[ j ], omega, look );
+                result[ theta_idx * numOmegas + o ] += amplitude.get( );
+            }
+        }
+    }
+
+} // namespace radiation
+} // namespace picongpu
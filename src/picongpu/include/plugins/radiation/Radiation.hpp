@@ -32,6 +32,8 @@
 
 #include "plugins/radiation/Radiation.kernel"
 #include "plugins/radiation/ExecuteParticleFilter.hpp"
+#include "plugins/radiation/RadiationCurrent.kernel"
+#include "fields/FieldJ.hpp"
 #include "plugins/ISimulationPlugin.hpp"
 #include "plugins/common/stringHelpers.hpp"
 
@@ -44,12 +46,17 @@
 #include "traits/HasIdentifier.hpp"
 
 #include <splash/splash.h>
+#include <hdf5.h>
 #include <boost/filesystem.hpp>
 
 #include <string>
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <boost/thread.hpp>
 
 
 namespace picongpu
@@ -114,6 +121,14 @@ private:
     bool radPerGPU;
     std::string folderRadPerGPU;
     DataSpace<simDim> lastGPUpos;
+    /* number of frequency tiles per direction in the radiation kernel */
+    uint32_t numOmegaTiles;
+    /* calculate the radiation of the current density instead of the particles */
+    bool fromCurrent;
+    /* current moment per super cell, only used if fromCurrent is set */
+    GridBuffer<float3_X, DIM1> *superCellCurrent;
+    /* compare the amplitudes of each n-th step with the host, 0 = disabled */
+    uint32_t checkHostPeriod;
 
     /** defines if all kernel dependencies are full filled
      *
@@ -139,6 +154,16 @@ private:
 
     uint32_t currentStep;
     uint32_t lastStep;
+    /* time step of the data written by the master output functions */
+    uint32_t outputStep;
+    /* write only HDF5 files, no text files */
+    bool binaryOnly;
+
+    /* non-blocking reduction of the last dump */
+    EventTask pendingReduce;
+    /* writes the output of the master in the background */
+    boost::thread writerThread;
+    bool isWriterActive;
 
     std::string pathRestart;
     std::string meshesPathName;
@@ -167,6 +192,13 @@ public:
     detectorFrequencies(nullptr),
     isMaster(false),
     currentStep(0),
+    outputStep(0),
+    binaryOnly(false),
+    isWriterActive(false),
+    numOmegaTiles(1),
+    fromCurrent(false),
+    superCellCurrent(nullptr),
+    checkHostPeriod(0),
     radPerGPU(false),
     lastStep(0),
     meshesPathName("DetectorMesh/"),
@@ -224,7 +256,10 @@ public:
                 ((pluginPrefix + ".omegaList").c_str(), po::value<std::string > (&pathOmegaList)->default_value("_noPath_"), "path to file containing all frequencies to calculate")
                 ((pluginPrefix + ".radPerGPU").c_str(), po::bool_switch(&radPerGPU), "enable radiation output from each GPU individually")
                 ((pluginPrefix + ".folderRadPerGPU").c_str(), po::value<std::string > (&folderRadPerGPU)->default_value("radPerGPU"), "folder in which the radiation of each GPU is written")
-                ((pluginPrefix + ".compression").c_str(), po::bool_switch(&compressionOn), "enable compression of hdf5 output");
+                ((pluginPrefix + ".compression").c_str(), po::bool_switch(&compressionOn), "enable compression of hdf5 output")
+                ((pluginPrefix + ".binaryOnly").c_str(), po::bool_switch(&binaryOnly), "write only hdf5 output, disables the text output of lastRadiation and totalRadiation")
+                ((pluginPrefix + ".fromCurrent").c_str(), po::bool_switch(&fromCurrent), "calculate the coherent far field of the current density of all species (coarse grained to super cells) instead of the particles of this species")
+                ((pluginPrefix + ".checkHost").c_str(), po::value<uint32_t > (&checkHostPeriod)->default_value(0), "compare the amplitudes of the particles with a calculation on the host [for each n-th step] (0 = disabled, slow)");
         }
         else
         {
@@ -271,6 +306,10 @@ public:
 
         if(dependenciesFulfilled)
         {
+            /* the output of the last dump must be finished */
+            waitForOutput();
+            outputStep = currentStep;
+
             // collect data GPU -> CPU -> Master
             copyRadiationDeviceToHost();
             collectRadiationOnMaster();
@@ -280,6 +319,11 @@ public:
             if (isMaster)
             {
                 writeHDF5file(tmp_result, restartDirectory + "/" + speciesName + std::string("_radRestart_"));
+
+                /* libSplash appends the position of the serial writer to the name */
+                std::ostringstream checkpointFile;
+                checkpointFile << speciesName << "_radRestart_" << outputStep << "_0_0_0.h5";
+                this->addCheckpointFile(checkpointFile.str());
             }
         }
     }
@@ -314,6 +358,12 @@ private:
                 freqInit.Init(pathOmegaList);
                 freqFkt = freqInit.getFunctor();
 
+                numOmegaTiles = getNumOmegaTiles();
+
+                if (fromCurrent)
+                    superCellCurrent = new GridBuffer<float3_X, DIM1 > (
+                        DataSpace<DIM1 > (getSuperCellsCount().productOfComponents()));
+
 
                 Environment<>::get().PluginConnector().setNotificationPeriod(this, notifyFrequency);
                 PMacc::Filesystem<simDim>& fs = Environment<simDim>::get().Filesystem();
@@ -384,10 +434,13 @@ private:
             DataSpace<simDim> globalOffset(subGrid.getLocalDomain().offset);
             globalOffset.y() += (localSize.y() * numSlides);
 
+            waitForOutput();
+
             // only print data at end of simulation if no dump period was set
             if (dumpPeriod == 0)
             {
                 collectDataGPUToMaster();
+                outputStep = currentStep;
                 writeAllFiles(globalOffset);
             }
 
@@ -399,6 +452,7 @@ private:
             }
 
             __delete(radiation);
+            __delete(superCellCurrent);
             CUDA_CHECK(cudaGetLastError());
         }
 
@@ -486,11 +540,11 @@ private:
       if (isMaster)
       {
           // write file only if lastRad flag was selected
-          if (lastRad)
+          if (lastRad && !binaryOnly)
           {
               // get time step as string
               std::stringstream o_step;
-              o_step << currentStep;
+              o_step << outputStep;
 
               // write lastRad data to txt
               writeFile(tmp_result, folderLastRad + "/" + filename_prefix + "_" + o_step.str() + ".dat");
@@ -506,11 +560,11 @@ private:
       if (isMaster)
       {
           // write file only if totalRad flag was selected
-          if (totalRad)
+          if (totalRad && !binaryOnly)
           {
               // get time step as string
               std::stringstream o_step;
-              o_step << currentStep;
+              o_step << outputStep;
 
               // write totalRad data to txt
               writeFile(timeSumArray, folderTotalRad + "/" + filename_prefix + "_" + o_step.str() + ".dat");
@@ -544,12 +598,107 @@ private:
   {
       // write data to files
       saveRadPerGPU(currentGPUpos);
+      writeMasterFiles();
+  }
+
+
+  /** write the output of the master (collected and time summed data) */
+  void writeMasterFiles()
+  {
       writeLastRadToText();
       writeTotalRadToText();
       writeAmplitudesToHDF5();
   }
 
 
+  /** start to collect the data from GPU to master without blocking
+   *
+   * The reduction is progressed by the event system. If it is finished
+   * the master sums the data over time and writes all files in a
+   * background thread, @see finishCollectDataGPUToMaster()
+   */
+  void startCollectDataGPUToMaster()
+  {
+      copyRadiationDeviceToHost();
+
+      /* the reduction of the last dump uses the same result arrays */
+      pendingReduce.waitForFinished();
+
+      const uint32_t step = currentStep;
+      pendingReduce = reduce.async(
+          nvidia::functors::Add(),
+          radiation->getHostBuffer().getBasePointer(),
+          elements_amplitude(),
+          mpi::reduceMethods::Reduce(),
+          [this, step](Amplitude const * result)
+          {
+              if (result != nullptr)
+                  this->finishCollectDataGPUToMaster(result, step);
+          }
+      );
+  }
+
+
+  /** sum the reduced data over time and write it in the background (master only)
+   *
+   * The files are written synchronously if HDF5 is not thread-safe, since
+   * other plugins use HDF5 from the main thread at the same time.
+   *
+   * @param result reduced amplitudes of all ranks
+   * @param step time step of the data
+   */
+  void finishCollectDataGPUToMaster(Amplitude const * result, const uint32_t step)
+  {
+      /* the writer thread of the last dump reads the result arrays */
+      joinWriter();
+
+      std::copy(result, result + elements_amplitude(), tmp_result);
+      sumAmplitudesOverTime(timeSumArray, tmp_result);
+
+      outputStep = step;
+      if (isHDF5ThreadSafe())
+      {
+          writerThread = boost::thread(&Radiation::writeMasterFiles, this);
+          isWriterActive = true;
+      }
+      else
+          writeMasterFiles();
+  }
+
+
+  /** can HDF5 be used by the writer thread and the main thread concurrently? */
+  static bool isHDF5ThreadSafe()
+  {
+#if H5_VERSION_GE(1, 8, 16)
+      hbool_t threadSafe = 0;
+      if (H5is_library_threadsafe(&threadSafe) < 0)
+          return false;
+      return threadSafe > 0;
+#else
+      return false;
+#endif
+  }
+
+
+  /** wait until the writer thread is finished */
+  void joinWriter()
+  {
+      if (isWriterActive)
+      {
+          writerThread.join();
+          isWriterActive = false;
+      }
+  }
+
+
+  /** wait until the reduction and the output of the last dump are finished */
+  void waitForOutput()
+  {
+      pendingReduce.waitForFinished();
+      joinWriter();
+  }
+
+
   /** This method returns hdf5 data structure names for amplitudes
    *
    *  Arguments:
@@ -672,7 +821,7 @@ private:
       fAttr.enableCompression = compressionOn;
 
       std::ostringstream filename;
-      filename << name << currentStep;
+      filename << name << outputStep;
 
       hdf5DataFile.open(filename.str().c_str(), fAttr);
 
@@ -705,7 +854,7 @@ private:
                                           stride);
 
           /* save data for each x/y/z * Re/Im amplitude */
-          hdf5DataFile.write(currentStep,
+          hdf5DataFile.write(outputStep,
                              radSplashType,
                              3,
                              dataSelection,
@@ -713,7 +862,7 @@ private:
                              values);
 
           /* save SI unit as attribute together with data set */
-          hdf5DataFile.writeAttribute(currentStep,
+          hdf5DataFile.writeAttribute(outputStep,
                                       radSplashType,
                                       (meshesPathName + dataLabels(ampIndex)).c_str(),
                                       "unitSI",
@@ -721,7 +870,7 @@ private:
 
           /* position */
           std::vector<float_X> positionMesh(simDim, 0.0); /* there is no offset - zero */
-          hdf5DataFile.writeAttribute(currentStep,
+          hdf5DataFile.writeAttribute(outputStep,
                                       splashFloatXType,
                                       (meshesPathName + dataLabels(ampIndex)).c_str(),
                                       "position",
@@ -731,7 +880,7 @@ private:
       }
 
       /* save SI unit as attribute in the Amplitude group (for convenience) */
-      hdf5DataFile.writeAttribute(currentStep,
+      hdf5DataFile.writeAttribute(outputStep,
                                   radSplashType,
                                   (meshesPathName + std::string("Amplitude")).c_str(),
                                   "unitSI",
@@ -756,7 +905,7 @@ private:
                                       offset,
                                       strideDetector);
 
-          hdf5DataFile.write(currentStep,
+          hdf5DataFile.write(outputStep,
                              radSplashType,
                              3,
                              dataSelection,
@@ -765,7 +914,7 @@ private:
 
           /* save SI unit as attribute together with data set */
           const picongpu::float_64 factorDirection = 1.0  ;
-          hdf5DataFile.writeAttribute(currentStep,
+          hdf5DataFile.writeAttribute(outputStep,
                                       radSplashType,
                                       (meshesPathName + dataLabelsDetectorDirection(detectorDim)).c_str(),
                                       "unitSI",
@@ -773,7 +922,7 @@ private:
 
           /* position */
           std::vector<float_X> positionMesh(simDim, 0.0); /* there is no offset - zero */
-          hdf5DataFile.writeAttribute(currentStep,
+          hdf5DataFile.writeAttribute(outputStep,
                                       splashFloatXType,
                                       (meshesPathName + dataLabelsDetectorDirection(detectorDim)).c_str(),
                                       "position",
@@ -798,7 +947,7 @@ private:
                                       offset,
                                       strideOmega);
 
-      hdf5DataFile.write(currentStep,
+      hdf5DataFile.write(outputStep,
                          radSplashType,
                          3,
                          dataSelection,
@@ -807,7 +956,7 @@ private:
 
       /* save SI unit as attribute together with data set */
       const picongpu::float_64 factorOmega = 1.0 / UNIT_TIME ;
-      hdf5DataFile.writeAttribute(currentStep,
+      hdf5DataFile.writeAttribute(outputStep,
                                   radSplashType,
                                   (meshesPathName + dataLabelsDetectorFrequency(0)).c_str(),
                                   "unitSI",
@@ -815,7 +964,7 @@ private:
 
       /* position */
       std::vector<float_X> positionMesh(simDim, 0.0); /* there is no offset - zero */
-      hdf5DataFile.writeAttribute(currentStep,
+      hdf5DataFile.writeAttribute(outputStep,
                                   splashFloatXType,
                                   (meshesPathName + dataLabelsDetectorFrequency(0)).c_str(),
                                   "position",
@@ -870,11 +1019,11 @@ private:
                                          "iterationFormat",
                                          iterationFormat.c_str() );
 
-      hdf5DataFile.writeAttribute(currentStep, splashFloatXType, nullptr, "dt", &DELTA_T);
-      const float_X time = float_X(currentStep) * DELTA_T;
-      hdf5DataFile.writeAttribute(currentStep, splashFloatXType, nullptr, "time", &time);
+      hdf5DataFile.writeAttribute(outputStep, splashFloatXType, nullptr, "dt", &DELTA_T);
+      const float_X time = float_X(outputStep) * DELTA_T;
+      hdf5DataFile.writeAttribute(outputStep, splashFloatXType, nullptr, "time", &time);
       splash::ColTypeDouble ctDouble;
-      hdf5DataFile.writeAttribute(currentStep, ctDouble, nullptr, "timeUnitSI", &UNIT_TIME);
+      hdf5DataFile.writeAttribute(outputStep, ctDouble, nullptr, "timeUnitSI", &UNIT_TIME);
 
       /* end required openPMD global attributes */
 
@@ -920,13 +1069,13 @@ private:
       {
           /* timeOffset */
           const float_X timeOffset = 0.0;
-          hdf5DataFile.writeAttribute(currentStep, splashFloatXType,
+          hdf5DataFile.writeAttribute(outputStep, splashFloatXType,
                                       (meshesPathName + meshRecordLabels(i)).c_str(),
                                       "timeOffset", &timeOffset);
 
           /* gridGlobalOffset */
           std::vector<float_64> gridGlobalOffset(simDim, 0.0); /* there is no offset - zero */
-          hdf5DataFile.writeAttribute(currentStep,
+          hdf5DataFile.writeAttribute(outputStep,
                                       ctDouble,
                                       (meshesPathName + meshRecordLabels(i)).c_str(),
                                       "gridGlobalOffset",
@@ -937,7 +1086,7 @@ private:
           /* gridUnit */
           /* ALL grids have indices as axises - thus no unit conversion */
           const double unitNone = 1.0;
-          hdf5DataFile.writeAttribute(currentStep,
+          hdf5DataFile.writeAttribute(outputStep,
                                       ctDouble,
                                       (meshesPathName + meshRecordLabels(i)).c_str(),
                                       "gridUnitSI",
@@ -946,7 +1095,7 @@ private:
           /* geometry */
           const std::string geometry("cartesian");
           splash::ColTypeString ctGeometry(geometry.length());
-          hdf5DataFile.writeAttribute(currentStep,
+          hdf5DataFile.writeAttribute(outputStep,
                                       ctGeometry,
                                       (meshesPathName + meshRecordLabels(i)).c_str(),
                                       "geometry",
@@ -955,7 +1104,7 @@ private:
           /* dataOrder */
           const std::string dataOrder("C");
           splash::ColTypeString ctDataOrder(dataOrder.length());
-          hdf5DataFile.writeAttribute(currentStep,
+          hdf5DataFile.writeAttribute(outputStep,
                                       ctDataOrder,
                                       (meshesPathName + meshRecordLabels(i)).c_str(),
                                       "dataOrder",
@@ -964,7 +1113,7 @@ private:
           std::vector<float_X> gridSpacing(simDim, 0.0);
           for( uint32_t d = 0; d < simDim; ++d )
               gridSpacing.at(d) = float_X(1.0);
-          hdf5DataFile.writeAttribute(currentStep,
+          hdf5DataFile.writeAttribute(outputStep,
                                       splashFloatXType,
                                       (meshesPathName + meshRecordLabels(i)).c_str(),
                                       "gridSpacing",
@@ -997,7 +1146,7 @@ private:
           myArrOfStr = getSplashArrayOfString( myListOfStr );
           splash::ColTypeString ctSomeListOfStr( myArrOfStr.maxLen );
 
-          hdf5DataFile.writeAttribute(currentStep,
+          hdf5DataFile.writeAttribute(outputStep,
                                       ctSomeListOfStr,
                                       (meshesPathName + meshRecordLabels(i)).c_str(),
                                       "axisLabels",
@@ -1024,7 +1173,7 @@ private:
               /* units 1./second -> Time^-1  */
               unitDimension[traits::SIBaseUnits::time] = -1.0;
           }
-          hdf5DataFile.writeAttribute(currentStep,
+          hdf5DataFile.writeAttribute(outputStep,
                                       ctDouble,
                                       (meshesPathName + meshRecordLabels(i)).c_str(),
                                       "unitDimension",
@@ -1145,6 +1294,124 @@ private:
       }
   }
 
+  /** get the number of local super cells without guard */
+  DataSpace<simDim> getSuperCellsCount() const
+  {
+      return cellDescription->getGridSuperCells() - 2 * cellDescription->getGuardingSuperCells();
+  }
+
+  /** get the number of frequency tiles per direction
+   *
+   * Every tile loads the particles of a frame again, therefore only as many
+   * tiles are used as needed to keep all multiprocessors busy.
+   */
+  uint32_t getNumOmegaTiles() const
+  {
+      const uint32_t blockSize = PMacc::math::CT::volume<typename MappingDesc::SuperCellSize>::type::value;
+      const uint32_t maxTiles = (radiation_frequencies::N_omega + blockSize - 1) / blockSize;
+
+      int device;
+      int numMultiProcessors;
+      CUDA_CHECK(cudaGetDevice(&device));
+      CUDA_CHECK(cudaDeviceGetAttribute(&numMultiProcessors, cudaDevAttrMultiProcessorCount, device));
+      /* several resident blocks per multiprocessor hide the latency */
+      const uint32_t minBlocks = 4u * uint32_t(numMultiProcessors);
+      const uint32_t neededTiles = (minBlocks + parameters::N_observer - 1) / parameters::N_observer;
+
+      return std::max(1u, std::min(maxTiles, neededTiles));
+  }
+
+  /** compare the amplitudes of this step with radiation::calculateAmplitudesHost
+   *
+   * The particles used by the radiation kernel are copied to the host and
+   * the amplitudes are calculated again. The largest deviation of an
+   * amplitude is printed relative to the largest amplitude of the device.
+   *
+   * @param particles species of this plugin
+   * @param deviceBefore amplitudes of the device before this step
+   * @param globalOffset offset of the local domain in the moving window
+   * @param simBoxSize global size of the simulation in cells
+   */
+  template<typename T_Particles>
+  void compareWithHost(T_Particles& particles,
+                       const std::vector<Amplitude>& deviceBefore,
+                       const DataSpace<simDim>& globalOffset,
+                       const DataSpace<simDim>& simBoxSize)
+  {
+      AreaMapping<CORE + BORDER, MappingDesc> mapper(*cellDescription);
+      const auto blockSize = PMacc::math::CT::volume<SuperCellSize>::type::value;
+
+      /* the first pass only counts the particles */
+      GridBuffer<uint64_cu, DIM1> counter(DataSpace<DIM1>(1));
+      counter.getDeviceBuffer().setValue(0);
+      PMACC_KERNEL(KernelRadiationCollectParticles<dependenciesFulfilled>{})
+        (mapper.getGridDim(), blockSize)
+        (particles->getDeviceParticlesBox(),
+         nullptr,
+         counter.getDeviceBuffer().getBasePointer(),
+         uint64_cu(0),
+         globalOffset,
+         mapper);
+      counter.deviceToHost();
+      const uint64_cu numParticles = *(counter.getHostBuffer().getBasePointer());
+
+      GridBuffer<radiation::ParticleData, DIM1> particleData(DataSpace<DIM1>(std::max(numParticles, uint64_cu(1))));
+      counter.getDeviceBuffer().setValue(0);
+      PMACC_KERNEL(KernelRadiationCollectParticles<dependenciesFulfilled>{})
+        (mapper.getGridDim(), blockSize)
+        (particles->getDeviceParticlesBox(),
+         particleData.getDeviceBuffer().getBasePointer(),
+         counter.getDeviceBuffer().getBasePointer(),
+         numParticles,
+         globalOffset,
+         mapper);
+      particleData.deviceToHost();
+
+      const radiation::ParticleData* data = particleData.getHostBuffer().getBasePointer();
+      std::vector< ::Particle > hostParticles;
+      std::vector<float_X> weightings;
+      hostParticles.reserve(numParticles);
+      weightings.reserve(numParticles);
+      for (uint64_cu i = 0; i < numParticles; ++i)
+      {
+          hostParticles.push_back(::Particle(data[i].locationNow, data[i].momentumOld,
+                                             data[i].momentumNow, data[i].mass));
+          weightings.push_back(data[i].weighting);
+      }
+
+      std::vector<Amplitude> hostResult(elements_amplitude(), Amplitude::zero());
+      radiation::calculateAmplitudesHost< radiation::AmplitudePrecision< parameters::mixedPrecision > >(
+          hostParticles,
+          weightings,
+          frame::getCharge<typename ParticlesType::FrameType>(),
+          float_64(currentStep) * float_64(DELTA_T),
+          freqFkt,
+          simBoxSize,
+          &hostResult[0]);
+
+      radiation->deviceToHost();
+      const Amplitude* deviceAfter = radiation->getHostBuffer().getBasePointer();
+
+      /* calc_radiation() is the squared norm of an amplitude times a constant */
+      float_64 maxDeviation = 0.0;
+      float_64 maxRadiation = 0.0;
+      for (unsigned int i = 0; i < elements_amplitude(); ++i)
+      {
+          Amplitude device = deviceAfter[i];
+          device -= deviceBefore[i];
+          Amplitude deviation = hostResult[i];
+          deviation -= device;
+          maxRadiation = std::max(maxRadiation, device.calc_radiation());
+          maxDeviation = std::max(maxDeviation, deviation.calc_radiation());
+      }
+      const float_64 relativeDeviation = maxRadiation > 0.0 ? std::sqrt(maxDeviation / maxRadiation) : 0.0;
+
+      std::cout << "Radiation (" << speciesName << "): step " << currentStep << ", rank "
+                << Environment<simDim>::get().GridController().getGlobalRank() << ", " << numParticles
+                << " particles, host amplitudes deviate by " << relativeDeviation
+                << " (relative to the largest device amplitude)" << std::endl;
+  }
+
   /**
    * This functions calls the radiation kernel. It specifies how the
    * calculation is parallelized.
@@ -1173,19 +1440,12 @@ private:
   {
       this->currentStep = currentStep;
 
-      DataConnector &dc = Environment<>::get().DataConnector();
-      auto particles = dc.get< ParticlesType >( ParticlesType::FrameType::getName(), true );
-
-      /* execute the particle filter */
-      radiation::executeParticleFilter( particles, currentStep );
-
-      /* the parallelization is ONLY over directions:
-       * (a combined parallelization over direction AND frequencies
-       * turned out to be slower on GPUs of the Fermi generation (sm_2x) (couple
-       * percent) and definitely slower on Kepler GPUs (sm_3x, tested on K20))
+      /* the parallelization is over directions and tiles of frequencies,
+       * the number of frequency tiles is chosen to fill the GPU
+       * @see getNumOmegaTiles()
        */
       const int N_observer = parameters::N_observer;
-      const auto gridDim_rad = N_observer;
+      const DataSpace<DIM2> gridDim_rad(N_observer, numOmegaTiles);
 
       /* number of threads per block = number of cells in a super cell
        *          = number of particles in a Frame
@@ -1205,28 +1465,81 @@ private:
       DataSpace<simDim> globalOffset(subGrid.getLocalDomain().offset);
       globalOffset.y() += (localSize.y() * numSlides);
 
+      DataConnector &dc = Environment<>::get().DataConnector();
+
+      if (fromCurrent)
+      {
+          auto fieldJ = dc.get< FieldJ >( FieldJ::getName(), true );
+
+          /* coarse grain the current density to super cells */
+          AreaMapping<CORE + BORDER, MappingDesc> mapper(*cellDescription);
+          PMACC_KERNEL(radiation::KernelSuperCellCurrent{})
+            (mapper.getGridDim(), MappingDesc::SuperCellSize::toRT())
+            (fieldJ->getDeviceDataBox(),
+             superCellCurrent->getDeviceBuffer().getBasePointer(),
+             getSuperCellsCount(),
+             mapper);
+
+          dc.releaseData( FieldJ::getName() );
+
+          PMACC_KERNEL(radiation::KernelRadiationCurrent{})
+            (gridDim_rad, blockDim_rad)
+            (
+             superCellCurrent->getDeviceBuffer().getBasePointer(),
+             radiation->getDeviceBuffer().getDataBox(),
+             globalOffset,
+             currentStep,
+             getSuperCellsCount(),
+             freqFkt,
+             subGrid.getGlobalDomain().size
+             );
+      }
+      else
+      {
+          auto particles = dc.get< ParticlesType >( ParticlesType::FrameType::getName(), true );
+
+          /* execute the particle filter */
+          radiation::executeParticleFilter( particles, currentStep );
 
-      // PIC-like kernel call of the radiation kernel
-      PMACC_KERNEL(KernelRadiationParticles<dependenciesFulfilled>{})
-        (gridDim_rad, blockDim_rad)
-        (
-         /*Pointer to particles memory on the device*/
-         particles->getDeviceParticlesBox(),
+          /* amplitudes before this step, the device only adds the contributions */
+          const bool checkHost = checkHostPeriod != 0 && currentStep % checkHostPeriod == 0;
+          std::vector<Amplitude> deviceBefore;
+          if (checkHost)
+          {
+              radiation->deviceToHost();
+              const Amplitude* hostAmplitudes = radiation->getHostBuffer().getBasePointer();
+              deviceBefore.assign(hostAmplitudes, hostAmplitudes + elements_amplitude());
+          }
 
-         /*Pointer to memory of radiated amplitude on the device*/
-         radiation->getDeviceBuffer().getDataBox(),
-         globalOffset,
-         currentStep, *cellDescription,
-         freqFkt,
-         subGrid.getGlobalDomain().size
-         );
+          // PIC-like kernel call of the radiation kernel
+          PMACC_KERNEL(KernelRadiationParticles<dependenciesFulfilled>{})
+            (gridDim_rad, blockDim_rad)
+            (
+             /*Pointer to particles memory on the device*/
+             particles->getDeviceParticlesBox(),
+
+             /*Pointer to memory of radiated amplitude on the device*/
+             radiation->getDeviceBuffer().getDataBox(),
+             globalOffset,
+             currentStep, *cellDescription,
+             freqFkt,
+             subGrid.getGlobalDomain().size
+             );
 
-      dc.releaseData( ParticlesType::FrameType::getName() );
+          if (checkHost)
+              compareWithHost(particles, deviceBefore, globalOffset, subGrid.getGlobalDomain().size);
+
+          dc.releaseData( ParticlesType::FrameType::getName() );
+      }
 
       if (dumpPeriod != 0 && currentStep % dumpPeriod == 0)
       {
-          collectDataGPUToMaster();
-          writeAllFiles(globalOffset);
+          /* reduction and output of the master are done asynchronously,
+           * the input of the reduction is copied, therefore the host buffer
+           * can be used for the output per GPU and the device buffer can be reset
+           */
+          startCollectDataGPUToMaster();
+          saveRadPerGPU(globalOffset);
 
           // update time steps
           lastStep = currentStep;
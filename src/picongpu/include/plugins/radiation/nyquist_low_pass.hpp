@@ -49,7 +49,7 @@ public:
     /**
      * checks if frequency omega is below Nyquist frequency
     **/
-    __device__ __host__ __forceinline__ bool check(const picongpu::float_32 omega)
+    __device__ __host__ __forceinline__ bool check(const picongpu::float_32 omega) const
     {
         return omega < omegaNyquist * picongpu::radiationNyquist::NyquistFactor;
     }
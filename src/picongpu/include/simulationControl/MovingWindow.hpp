@@ -36,7 +36,7 @@ class MovingWindow
 {
 private:
 
-    MovingWindow() : slidingWindowActive(false), slideCounter(0), lastSlideStep(0)
+    MovingWindow() : slidingWindowActive(false), slideCounter(0), lastSlideStep(0), initAfterSlide(false)
     {
     }
 
@@ -198,6 +198,9 @@ private:
      * used to prevent multiple slides per simulation step
      */
     uint32_t lastSlideStep;
+
+    /** true while the GPUs moved by a slide are filled with new data */
+    bool initAfterSlide;
 public:
 
     /**
@@ -225,6 +228,27 @@ public:
         lastSlideStep = currentStep;
     }
 
+    /**
+     * Mark that only the GPUs moved to the end by a slide are initialized
+     *
+     * @param value true while the new GPUs are filled, false afterwards
+     */
+    void setInitAfterSlide(bool value)
+    {
+        initAfterSlide = value;
+    }
+
+    /**
+     * Return if only the GPUs moved by a slide are initialized.
+     * Collective operations over all ranks are not allowed in this case.
+     *
+     * @return true during the initialization after a slide, false otherwise
+     */
+    bool isInitAfterSlide() const
+    {
+        return initAfterSlide;
+    }
+
     /**
      * Return the number of slides since start of simulation.
      * If slide occurs in \p currentStep, it is included in the result.
@@ -37,6 +37,8 @@
 #include "particles/bremsstrahlung/PhotonEmissionAngle.hpp"
 
 #include "eventSystem/EventSystem.hpp"
+#include "debug/Tracer.hpp"
+#include "simulationControl/StartupScheduler.hpp"
 #include "dimensions/GridLayout.hpp"
 #include "fields/LaserPhysics.hpp"
 #include "nvidia/memory/MemoryInfo.hpp"
@@ -107,6 +109,7 @@ public:
     pushBGField(nullptr),
     currentBGField(nullptr),
     cellDescription(nullptr),
+    hasPendingLookupTables(false),
     initialiserController(nullptr),
     slidingWindow(false)
     {
@@ -275,6 +278,8 @@ public:
 
         DataConnector &dc = Environment<>::get().DataConnector();
 
+        StartupStage stage("createFields");
+
         // create simulation data such as fields and particles
         auto fieldB = new FieldB( *cellDescription );
         dc.share( std::shared_ptr< ISimulationData >( fieldB ) );
@@ -295,6 +300,8 @@ public:
 
         laser = new LaserPhysics(cellDescription->getGridLayout());
 
+        stage.next("initRNG");
+
         // Initialize random number generator and synchrotron functions, if there are synchrotron or bremsstrahlung Photons
         typedef typename PMacc::particles::traits::FilterByFlag<VectorAllSpecies,
                                                                 synchrotronPhotons<> >::type AllSynchrotronPhotonsSpecies;
@@ -320,10 +327,25 @@ public:
             dc.share( std::shared_ptr< ISimulationData >( rngFactory ) );
         }
 
+        stage.next("prepareLookupTables");
+
+        /* The lookup tables are allocated here and computed on host threads
+         * concurrently to the particle creation, they are copied to the
+         * device in uploadLookupTables().
+         */
+
         // Initialize synchrotron functions, if there are synchrotron photon species
         if(!bmpl::empty<AllSynchrotronPhotonsSpecies>::value)
         {
-            this->synchrotronFunctions.init();
+            this->synchrotronFunctions.prepareTables();
+            StartupScheduler::getInstance().startHostStage(
+                "synchrotronFunctions",
+                [this]()
+                {
+                    this->synchrotronFunctions.computeTables();
+                }
+            );
+            this->hasPendingLookupTables = true;
         }
 
         // Initialize bremsstrahlung lookup tables, if there are species containing bremsstrahlung photons
@@ -335,9 +357,28 @@ public:
             > fillScaledSpectrumMap;
             fillScaledSpectrumMap(forward(this->scaledBremsstrahlungSpectrumMap));
 
-            this->bremsstrahlungPhotonAngle.init();
+            this->bremsstrahlungPhotonAngle.prepareTable();
+
+            StartupScheduler::getInstance().startHostStage(
+                "bremsstrahlungSpectrum",
+                [this]()
+                {
+                    for(auto& scaledSpectrum : this->scaledBremsstrahlungSpectrumMap)
+                        scaledSpectrum.second.computeTables();
+                }
+            );
+            StartupScheduler::getInstance().startHostStage(
+                "bremsstrahlungPhotonAngle",
+                [this]()
+                {
+                    this->bremsstrahlungPhotonAngle.computeTable();
+                }
+            );
+            this->hasPendingLookupTables = true;
         }
 
+        stage.next("createSpecies");
+
         /* Create an empty allocator. This one is resized after all exchanges
          * for particles are created */
         deviceHeap.reset(new DeviceHeap(0));
@@ -379,6 +420,8 @@ public:
         Environment<>::get().MemoryInfo().getMemoryInfo(&freeGpuMem);
         log<picLog::MEMORY > ("free mem after all mem is allocated %1% MiB") % (freeGpuMem / 1024 / 1024);
 
+        stage.next("initFields");
+
         IdProvider<simDim>::init();
 
         fieldB->init( *laser );
@@ -393,6 +436,7 @@ public:
         // create current interpolation
         this->myCurrentInterpolation = new fieldSolver::CurrentInterpolation;
 
+        stage.next("initSpecies");
 
         ForEach< VectorAllSpecies, particles::CallInit<bmpl::_1> > particleInit;
         particleInit( );
@@ -420,6 +464,7 @@ public:
         /* fill all objects registed in DataConnector */
         if (initialiserController)
         {
+            StartupStage stage("initialiserController");
             initialiserController->printInformation();
             if (this->restartRequested)
             {
@@ -442,11 +487,14 @@ public:
             else
             {
                 initialiserController->init();
+                stage.next("initPipeline");
                 ForEach< particles::InitPipeline, particles::CallFunctor<bmpl::_1> > initSpecies;
                 initSpecies( step );
             }
         }
 
+        uploadLookupTables();
+
         size_t freeGpuMem(0u);
         Environment<>::get().MemoryInfo().getMemoryInfo(&freeGpuMem);
         log<picLog::MEMORY > ("free mem after all particles are initialized %1% MiB") % (freeGpuMem / 1024 / 1024);
@@ -490,6 +538,9 @@ public:
     {
         namespace nvfct = PMacc::nvidia::functors;
 
+        /* each phase of the step is recorded as region if tracing is enabled */
+        TraceScope tracePhase("copyMomentumPrev1", "step");
+
         typedef typename PMacc::particles::traits::FilterByIdentifier
         <
             VectorAllSpecies,
@@ -511,6 +562,7 @@ public:
 
         DataConnector &dc = Environment<>::get().DataConnector();
 
+        tracePhase.next("ionization");
         /* Initialize ionization routine for each species with the flag `ionizers<>` */
         using VectorSpeciesWithIonizers = typename PMacc::particles::traits::FilterByFlag<
             VectorAllSpecies,
@@ -519,6 +571,7 @@ public:
         ForEach< VectorSpeciesWithIonizers, particles::CallIonization< bmpl::_1 > > particleIonization;
         particleIonization( cellDescription, currentStep );
 
+        tracePhase.next("synchrotronPhotons");
         /* call the synchrotron radiation module for each radiating species (normally electrons) */
         typedef typename PMacc::particles::traits::FilterByFlag<VectorAllSpecies,
                                                                 synchrotronPhotons<> >::type AllSynchrotronPhotonsSpecies;
@@ -529,6 +582,7 @@ public:
         > synchrotronRadiation;
         synchrotronRadiation( cellDescription, currentStep, this->synchrotronFunctions );
 
+        tracePhase.next("bremsstrahlung");
         /* Bremsstrahlung */
         typedef typename PMacc::particles::traits::FilterByFlag
         <
@@ -549,10 +603,13 @@ public:
         EventTask updateEvent;
         EventTask commEvent;
 
+        tracePhase.next("particlePush");
         /* push all species */
         particles::PushAllSpecies pushAllSpecies;
         pushAllSpecies( currentStep, initEvent, updateEvent, commEvent );
 
+        tracePhase.next("fieldSolverBeforeCurrent");
+
         __setTransactionEvent(updateEvent);
         /** remove background field for particle pusher */
         auto fieldE = dc.get< FieldE >( FieldE::getName(), true );
@@ -571,6 +628,7 @@ public:
         fieldJ->assign( zeroJ );
 
         __setTransactionEvent(commEvent);
+        tracePhase.next("currentDeposition");
         (*currentBGField)(fieldJ, nvfct::Add(), FieldBackgroundJ(fieldJ->getUnit()),
                           currentStep, FieldBackgroundJ::activated);
 #if (ENABLE_CURRENT == 1)
@@ -592,6 +650,7 @@ public:
 #if  (ENABLE_CURRENT == 1)
         if(bmpl::size<VectorSpeciesWithCurrentSolver>::type::value > 0)
         {
+            tracePhase.next("currentExchangeAndAddToEMF");
             EventTask eRecvCurrent = fieldJ->asyncCommunication(__getTransactionEvent());
 
             const DataSpace<simDim> currentRecvLower( GetMargin<fieldSolver::CurrentInterpolation>::LowerMargin( ).toRT( ) );
@@ -621,6 +680,7 @@ public:
 #endif
         dc.releaseData( FieldJ::getName() );
 
+        tracePhase.next("fieldSolverAfterCurrent");
         this->myFieldSolver->update_afterCurrent(currentStep);
     }
 
@@ -677,9 +737,12 @@ public:
         {
             log<picLog::SIMULATION_STATE > ("slide in step %1%") % currentStep;
             resetAll(currentStep);
+            /* only the slid GPUs are initialized, see MovingWindow::isInitAfterSlide() */
+            MovingWindow::getInstance().setInitAfterSlide(true);
             initialiserController->slide(currentStep);
             ForEach< particles::InitPipeline, particles::CallFunctor< bmpl::_1 > > initSpecies;
             initSpecies( currentStep );
+            MovingWindow::getInstance().setInitAfterSlide(false);
         }
     }
 
@@ -717,6 +780,37 @@ private:
     }
 
 protected:
+
+    /** wait for the lookup tables computed on host threads and copy them to the device
+     *
+     * The computation is started in init(), the tables are not used before the first step.
+     */
+    void uploadLookupTables()
+    {
+        if (!hasPendingLookupTables)
+            return;
+
+        StartupScheduler::getInstance().waitForHostStages();
+        StartupStage stage("uploadLookupTables");
+
+        typedef typename PMacc::particles::traits::FilterByFlag<VectorAllSpecies,
+                                                                synchrotronPhotons<> >::type AllSynchrotronPhotonsSpecies;
+        typedef typename PMacc::particles::traits::FilterByFlag<VectorAllSpecies,
+                                                                bremsstrahlungPhotons<> >::type AllBremsstrahlungPhotonsSpecies;
+
+        if(!bmpl::empty<AllSynchrotronPhotonsSpecies>::value)
+            this->synchrotronFunctions.uploadTables();
+
+        if(!bmpl::empty<AllBremsstrahlungPhotonsSpecies>::value)
+        {
+            for(auto& scaledSpectrum : this->scaledBremsstrahlungSpectrumMap)
+                scaledSpectrum.second.uploadTables();
+            this->bremsstrahlungPhotonAngle.uploadTable();
+        }
+
+        hasPendingLookupTables = false;
+    }
+
     std::shared_ptr<DeviceHeap> deviceHeap;
 
     // field solver
@@ -736,6 +830,9 @@ protected:
     // Synchrotron functions (used in synchrotronPhotons module)
     particles::synchrotronPhotons::SynchrotronFunctions synchrotronFunctions;
 
+    // true if the lookup tables are computed but not yet copied to the device
+    bool hasPendingLookupTables;
+
     // output classes
 
     IInitPlugin* initialiserController;
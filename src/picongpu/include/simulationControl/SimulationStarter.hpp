@@ -33,6 +33,7 @@
 #include "mappings/kernel/MappingDescription.hpp"
 #include "pluginSystem/PluginConnector.hpp"
 #include "simulationControl/ISimulationStarter.hpp"
+#include "simulationControl/StartupScheduler.hpp"
 
 namespace picongpu
 {
@@ -75,7 +76,10 @@ namespace picongpu
         virtual void start()
         {
             PluginConnector& pluginConnector = Environment<>::get().PluginConnector();
-            pluginConnector.loadPlugins();
+            {
+                StartupStage stage("loadPlugins");
+                pluginConnector.loadPlugins();
+            }
             log<picLog::SIMULATION_STATE > ("Startup");
             simulationClass->setInitController(initClass);
             simulationClass->startSimulation();
@@ -122,7 +126,10 @@ namespace picongpu
 
         void pluginLoad()
         {
-            simulationClass->load();
+            {
+                StartupStage stage("loadSimulation");
+                simulationClass->load();
+            }
             mappingDesc = simulationClass->getMappingDescription();
             pluginClass->setMappingDescription(mappingDesc);
             initClass->setMappingDescription(mappingDesc);
@@ -20,6 +20,8 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <cstring>
 #include <pngwriter.h>
 #include <splash/splash.h>
 #include <mpi.h>
@@ -36,6 +38,7 @@ typedef struct
     int iteration;
     Dimensions dataSize;
     Dimensions dataOffset;
+    uint32_t smoothRadius;
 } Options;
 
 bool parseCmdLine(int argc, char **argv, Options &options)
@@ -48,9 +51,10 @@ bool parseCmdLine(int argc, char **argv, Options &options)
         options.densityDataset = "fields/e_chargeDensity";
         options.dataOffset.set(0, 0, 0);
         options.iteration = 0;
+        options.smoothRadius = 0;
 
         std::stringstream desc_stream;
-        desc_stream << "Usage " << argv[0] << " <png-file> -g width height depth [options]" << std::endl;
+        desc_stream << "Usage [mpiexec -n N] " << argv[0] << " <png-file> -g width height depth [options]" << std::endl;
 
         // add possible options
         po::options_description desc(desc_stream.str());
@@ -65,6 +69,8 @@ bool parseCmdLine(int argc, char **argv, Options &options)
                 "Output filename (basepart)")
                 ("dataset,d", po::value<std::string > (&options.densityDataset)->default_value(options.densityDataset),
                 "Fully qualified density HDF5 dataset name")
+                ("smooth", po::value<uint32_t > (&options.smoothRadius)->default_value(options.smoothRadius),
+                "Radius in cells of a box filter applied to the density in x and y, 0 = disabled")
                 ;
 
         po::positional_options_description pos_options_descr;
@@ -119,88 +125,223 @@ bool parseCmdLine(int argc, char **argv, Options &options)
     return true;
 }
 
-int main(int argc, char **argv)
+/**
+ * Interpolate an image bilinearly to the x-y plane of the grid.
+ *
+ * Image rows are mapped to x (first row to x = 0), image columns to y.
+ * If the image size matches the grid, each cell gets the value of one pixel.
+ *
+ * @param pixels image values, row by row from the top
+ * @param width image width
+ * @param height image height
+ * @param sizeX number of cells in x
+ * @param sizeY number of cells in y
+ * @param plane output with sizeX * sizeY values, x is the fast index
+ */
+void interpolatePlane(const std::vector<float>& pixels, size_t width, size_t height,
+                      size_t sizeX, size_t sizeY, std::vector<float>& plane)
 {
-    Options options;
-    if (!parseCmdLine(argc, argv, options))
-        return -1;
+    /* interpolation along x: rows and weights are the same for all columns */
+    std::vector<size_t> row0(sizeX), row1(sizeX);
+    std::vector<float> rowWeight(sizeX);
+    for (size_t x = 0; x < sizeX; ++x)
+    {
+        const double pos = std::min(std::max((x + 0.5) * height / sizeX - 0.5, 0.0), double(height - 1));
+        row0[x] = size_t(pos);
+        row1[x] = std::min(row0[x] + 1, height - 1);
+        rowWeight[x] = float(pos - row0[x]);
+    }
 
-    MPI_Init(nullptr, nullptr);
+    /* each image column resampled to the cells along x, computed once
+     * per column instead of once per y */
+    std::vector<float> columns(width * sizeX);
+    for (size_t col = 0; col < width; ++col)
+    {
+        float *resampled = &columns[col * sizeX];
+        for (size_t x = 0; x < sizeX; ++x)
+        {
+            const float p0 = pixels[row0[x] * width + col];
+            const float p1 = pixels[row1[x] * width + col];
+            resampled[x] = p0 + rowWeight[x] * (p1 - p0);
+        }
+    }
 
-    Dimensions data_size(options.dataSize);
-    std::cout << "Creating density data with size " << data_size.toString() << std::endl;
+    /* interpolation along y: the inner loop over x reads two resampled
+     * columns contiguously and vectorizes */
+    for (size_t y = 0; y < sizeY; ++y)
+    {
+        const double pos = std::min(std::max((y + 0.5) * width / sizeY - 0.5, 0.0), double(width - 1));
+        const size_t col0 = size_t(pos);
+        const size_t col1 = std::min(col0 + 1, width - 1);
+        const float colWeight = float(pos - col0);
+
+        const float *c0 = &columns[col0 * sizeX];
+        const float *c1 = &columns[col1 * sizeX];
+        float *out = &plane[y * sizeX];
+        for (size_t x = 0; x < sizeX; ++x)
+            out[x] = c0[x] + colWeight * (c1[x] - c0[x]);
+    }
+}
 
-    std::cout << " Reading PNG file '" << options.filename << "'" << std::endl;
-    pngwriter image(data_size[1], data_size[0], 0, (options.filename + std::string(".tmp")).c_str());
-    image.readfromfile(options.filename.c_str());
+/**
+ * Box filter with a radius of `radius` cells in x and y, cells outside of
+ * the plane have the value of the closest border cell.
+ */
+void smoothPlane(std::vector<float>& plane, size_t sizeX, size_t sizeY, size_t radius)
+{
+    const float norm = 1.0f / float(2 * radius + 1);
+    std::vector<float> tmp(plane.size());
 
-    if (image.getwidth() != (int) data_size[1] || image.getheight() != (int) data_size[0])
+    /* along x: running sum per line */
+    for (size_t y = 0; y < sizeY; ++y)
+    {
+        const float *in = &plane[y * sizeX];
+        float *out = &tmp[y * sizeX];
+        double sum = 0.0;
+        for (long i = -long(radius); i <= long(radius); ++i)
+            sum += in[std::min(size_t(std::max(i, 0l)), sizeX - 1)];
+        for (size_t x = 0; x < sizeX; ++x)
+        {
+            out[x] = float(sum) * norm;
+            const size_t add = std::min(x + radius + 1, sizeX - 1);
+            const size_t remove = x >= radius ? x - radius : 0;
+            sum += in[add] - in[remove];
+        }
+    }
+
+    /* along y: whole lines are added, the inner loop over x vectorizes */
+    std::vector<float> sum(sizeX, 0.0f);
+    for (long i = -long(radius); i <= long(radius); ++i)
+    {
+        const float *in = &tmp[std::min(size_t(std::max(i, 0l)), sizeY - 1) * sizeX];
+        for (size_t x = 0; x < sizeX; ++x)
+            sum[x] += in[x];
+    }
+    for (size_t y = 0; y < sizeY; ++y)
+    {
+        const float *add = &tmp[std::min(y + radius + 1, sizeY - 1) * sizeX];
+        const float *remove = &tmp[(y >= radius ? y - radius : 0) * sizeX];
+        float *out = &plane[y * sizeX];
+        for (size_t x = 0; x < sizeX; ++x)
+        {
+            out[x] = sum[x] * norm;
+            sum[x] += add[x] - remove[x];
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    MPI_Init(nullptr, nullptr);
+
+    int rank, numRanks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+
+    Options options;
+    if (!parseCmdLine(argc, argv, options))
     {
-        image.close();
-        std::cerr << "Invalid image size (" << image.getwidth() << "," <<
-                image.getheight() << ") for data size" << std::endl;
         MPI_Finalize();
         return -1;
     }
 
-    float *data = new float[data_size.getScalarSize()];
-    memset(data, 0, data_size.getScalarSize() * sizeof (float));
+    Dimensions data_size(options.dataSize);
+    const size_t planeSize = data_size[0] * data_size[1];
+    std::vector<float> plane(planeSize);
+    int status = 0;
+
+    /* the x-y plane is created by the first rank and extended in z by all ranks */
+    if (rank == 0)
+    {
+        std::cout << "Creating density data with size " << data_size.toString() <<
+                " on " << numRanks << " rank(s)" << std::endl;
+
+        std::cout << " Reading PNG file '" << options.filename << "'" << std::endl;
+        pngwriter image(1, 1, 0, (options.filename + std::string(".tmp")).c_str());
+        image.readfromfile(options.filename.c_str());
 
-    for (size_t x = 0; x < data_size[0]; ++x)
-        for (size_t y = 0; y < data_size[1]; ++y)
+        const int width = image.getwidth();
+        const int height = image.getheight();
+        if (width < 1 || height < 1)
+        {
+            std::cerr << "Invalid image size (" << width << "," << height << ")" << std::endl;
+            status = -1;
+        }
+        else
         {
+            if (width != (int) data_size[1] || height != (int) data_size[0])
+                std::cout << " Interpolating image of size (" << width << "," << height <<
+                        ") to data size" << std::endl;
+
             /* pngwriter coordinates start at (1,1) and the y direction is inverted */
-            int pos_x = 1 + y;
-            int pos_y = 1 + (data_size[0] - x - 1);
+            std::vector<float> pixels(width * height);
+            for (int row = 0; row < height; ++row)
+                for (int col = 0; col < width; ++col)
+                {
+                    const double color = image.dreadHSV(col + 1, height - row, 3);
+                    image.plot(col + 1, height - row, color, color, color);
+                    pixels[row * width + col] = float(color);
+                }
+
+            interpolatePlane(pixels, width, height, data_size[0], data_size[1], plane);
+            if (options.smoothRadius != 0)
+                smoothPlane(plane, data_size[0], data_size[1], options.smoothRadius);
+        }
 
-            double color = image.dreadHSV(pos_x, pos_y, 3);
+        /* write and close the output png */
+        image.close();
+    }
 
-            image.plot(pos_x, pos_y, color, color, color);
+    MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (status != 0)
+    {
+        MPI_Finalize();
+        return status;
+    }
+    MPI_Bcast(&plane[0], planeSize, MPI_FLOAT, 0, MPI_COMM_WORLD);
 
-            for (size_t z = 0; z < data_size[2]; ++z)
-            {
-                size_t index = z * (data_size[0] * data_size[1]) + y * data_size[0] + x;
-                data[index] = color;
-            }
-        }
+    /* each rank creates and writes a slab of z planes */
+    const size_t zBegin = data_size[2] * rank / numRanks;
+    const size_t zEnd = data_size[2] * (rank + 1) / numRanks;
+    Dimensions local_size(data_size[0], data_size[1], zEnd - zBegin);
 
-    /* write and close the output png */
-    image.close();
+    std::vector<float> data(local_size.getScalarSize());
+    for (size_t z = 0; z < local_size[2]; ++z)
+        std::copy(plane.begin(), plane.end(), data.begin() + z * planeSize);
 
-    std::cout << " Creating density HDF5 file '" << options.densityFilename << "_" <<
-            options.iteration << ".h5'" << std::endl;
+    if (rank == 0)
+        std::cout << " Creating density HDF5 file '" << options.densityFilename << "_" <<
+                options.iteration << ".h5'" << std::endl;
 
-    /* write density information to HDF5 */
+    /* write density information to HDF5, one slab per rank along z */
     ParallelDomainCollector *pdc = new
-            ParallelDomainCollector(MPI_COMM_WORLD, MPI_INFO_NULL, Dimensions(1, 1, 1), 1);
+            ParallelDomainCollector(MPI_COMM_WORLD, MPI_INFO_NULL, Dimensions(1, 1, numRanks), 1);
     DataCollector::FileCreationAttr attr;
     DataCollector::initFileCreationAttr(attr);
+    attr.mpiPosition.set(0, 0, rank);
+    attr.mpiSize.set(1, 1, numRanks);
     pdc->open(options.densityFilename.c_str(), attr);
 
     ColTypeFloat ctFloat;
     pdc->writeDomain(
             options.iteration,
+            data_size,
+            Dimensions(0, 0, zBegin),
             ctFloat,
             data_size.getDims(),
-            Selection(data_size),
+            Selection(local_size),
             options.densityDataset.c_str(),
             Domain(
                    options.dataOffset,
                    data_size
             ),
-            Domain(
-                   options.dataOffset,
-                   data_size
-            ),
             DomainCollector::GridType,
-            data);
+            data.empty() ? nullptr : &data[0]);
 
     pdc->close();
     pdc->finalize();
     delete pdc;
 
-    delete[] data;
-
     MPI_Finalize();
 
     return 0;
@@ -82,6 +82,44 @@ def readFieldSlices(File):
     return data
 
 
+def readFieldSlicesBinary(File):
+    """
+    Function to read one binary data file (format=binary) from PIConGPUs
+    SliceFieldPrinter plug-in and returns the field data as array of size
+    [N_y, N_x, 3] (3D simulations) or [N_x, 3] (2D simulations).
+
+    Parameters:
+    -----------
+    File: either a file of type file which points to the data file or
+          a filename of type str with the path to the data file
+
+    Returns:
+    --------
+    numpy-array with field data in SI units
+    """
+    # case: file or filename
+    if type(File) is file:
+        theFile = File
+    elif type(File) is str:
+        theFile = open(File, 'rb')
+    else:
+        # if neither trow arrow
+        raise IOError("the argument - {} - is not a file".format(File))
+
+    magic = theFile.read(8)
+    if magic != "PICSLICE":
+        raise IOError("the file is not a binary SliceFieldPrinter file")
+    version, dim = _numpy.fromfile(theFile, dtype='<u4', count=2)
+    if version != 1:
+        raise IOError("unsupported version {} of the binary format".format(version))
+    # extents are stored with x first
+    extent = _numpy.fromfile(theFile, dtype='<u8', count=dim)
+
+    data = _numpy.fromfile(theFile, dtype='<f8',
+                           count=int(_numpy.prod(extent)) * 3)
+    return data.reshape(tuple(extent[::-1]) + (3,))
+
+
 
 if __name__ == '__main__':
     import matplotlib.pyplot as plt
@@ -100,7 +138,10 @@ if __name__ == '__main__':
     args = parser.parse_args()
 
     # load data from file using this module
-    data = readFieldSlices(args.file)
+    if args.file.name.endswith(".bin"):
+        data = readFieldSlicesBinary(args.file)
+    else:
+        data = readFieldSlices(args.file)
 
     # show data (field_x only)
     plt.imshow(data[:,:,0])
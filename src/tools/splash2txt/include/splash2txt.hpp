@@ -82,6 +82,13 @@ enum FileMode { FM_SPLASH = 0
 #endif
 };
 
+typedef struct
+{
+    std::string name; // name of the dataset
+    double minValue; // smallest value passing the filter (with unit)
+    double maxValue; // largest value passing the filter (with unit)
+} DatasetFilter;
+
 typedef struct
 {
     FileMode fileMode; // type of input file
@@ -97,6 +104,13 @@ typedef struct
     bool verbose; // verbose output on stdout
     bool listDatasets; // list available datasets
     bool applyUnits; // apply the unit stored in HDF5 to the output data
+    bool stream; // read and convert data in chunks
+    size_t chunkSize; // number of elements per dataset and chunk in stream mode
+    uint32_t numThreads; // threads formatting the output in stream mode
+    bool binary; // write raw float64 values instead of text in stream mode
+    uint64_t particleBegin; // first particle printed in stream mode
+    uint64_t particleEnd; // end of the printed particle range in stream mode
+    std::vector<DatasetFilter> filters; // particle filters in stream mode
 } ProgramOptions;
 
 #endif    /* SPLASH2TXT_HPP */
@@ -22,6 +22,8 @@
 #define TOOLS_SPLASH_PARALLEL_HPP
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "splash/splash.h"
 #include "ITools.hpp"
@@ -34,6 +36,18 @@ typedef struct
     double unit;
 } ExDataContainer;
 
+/** dataset read in chunks by the stream mode */
+typedef struct
+{
+    std::string name;
+    DCDataType dataType;
+    size_t typeSize;
+    double unit;
+    Dimensions size;
+    /* chunk buffers, one is formatted while the other one is read */
+    std::vector<char> buffer[2];
+} StreamDataset;
+
 class ToolsSplashParallel : public ITools
 {
 public:
@@ -59,6 +73,10 @@ protected:
     void printElement(DCDataType dataType,
             void* elem, double unit, std::string delimiter);
 
+    void convertStreaming(DomainCollector::DomDataClass dataClass);
+
+    StreamDataset openStreamDataset(const std::string& name);
+
     ParallelDomainCollector dc;
     std::ostream &errorStream;
 };
@@ -21,6 +21,9 @@
 
 #include "splash2txt.hpp"
 
+#include <boost/lexical_cast.hpp>
+#include <limits>
+
 #include "tools_splash_parallel.hpp"
 
 #if (ENABLE_ADIOS==1)
@@ -45,6 +48,8 @@ bool parseOptions( int argc, char** argv, ProgramOptions &options )
 
     std::string slice_string = "";
     std::string filemode = "splash";
+    std::string particle_range = "";
+    std::vector<std::string> filter_strings;
 
 #if (ENABLE_ADIOS==1)
     const std::string filemodeOptions = "[splash,adios]";
@@ -67,6 +72,13 @@ bool parseOptions( int argc, char** argv, ProgramOptions &options )
         ( "offset", po::value<size_t > ( &options.sliceOffset )->default_value( 0 ), "offset of slice in dataset" )
         ( "delimiter", po::value<std::string>( &options.delimiter )->default_value( " " ), "select a delimiter for data elements. default is a single space character" )
         ( "no-units", "no conversion of stored data elements with their respective unit" )
+        ( "stream", "read and convert the datasets in chunks, for large files (splash mode)" )
+        ( "chunk-size", po::value<size_t > ( &options.chunkSize )->default_value( 1024 * 1024 ), "stream mode: number of elements per dataset read at once" )
+        ( "threads", po::value<uint32_t > ( &options.numThreads )->default_value( 0 ), "stream mode: number of threads formatting the output, 0 = all cores" )
+        ( "binary", "stream mode: write the values as raw float64 (with units applied) instead of text" )
+        ( "particle-range", po::value< std::string > ( &particle_range ), "stream mode: print only the particles begin:end (end exclusive)" )
+        ( "filter", po::value<std::vector<std::string> > ( &filter_strings )->multitoken( ), "stream mode: print only particles with min <= value <= max "
+          "(in the units of the output) of a dataset, syntax name:min:max, the dataset is not printed if it is not selected with --data" )
         ;
 
     po::positional_options_description pos_options;
@@ -111,6 +123,48 @@ bool parseOptions( int argc, char** argv, ProgramOptions &options )
         options.listDatasets = vm.count( "list" ) != 0;
         options.toFile = vm.count( "output-file" ) != 0;
         options.applyUnits = vm.count( "no-units" ) == 0;
+        options.binary = vm.count( "binary" ) != 0;
+        options.stream = vm.count( "stream" ) != 0 || options.binary ||
+            vm.count( "particle-range" ) != 0 || vm.count( "filter" ) != 0;
+
+        if ( options.chunkSize == 0 )
+        {
+            errorStream << "Parameter 'chunk-size' must be greater than zero." << std::endl;
+            return false;
+        }
+
+        options.particleBegin = 0;
+        options.particleEnd = std::numeric_limits<uint64_t>::max( );
+        if ( vm.count( "particle-range" ) )
+        {
+            const size_t colon = particle_range.find( ':' );
+            if ( colon == std::string::npos )
+            {
+                errorStream << "Invalid input for parameter 'particle-range'. Accepted: begin:end" << std::endl;
+                return false;
+            }
+            options.particleBegin = boost::lexical_cast<uint64_t>( particle_range.substr( 0, colon ) );
+            if ( colon + 1 != particle_range.size( ) )
+                options.particleEnd = boost::lexical_cast<uint64_t>( particle_range.substr( colon + 1 ) );
+        }
+
+        for ( size_t i = 0; i < filter_strings.size( ); ++i )
+        {
+            // the dataset name may not contain ':', the limits are separated from the end
+            const size_t maxColon = filter_strings[i].rfind( ':' );
+            const size_t minColon = maxColon == std::string::npos || maxColon == 0 ?
+                std::string::npos : filter_strings[i].rfind( ':', maxColon - 1 );
+            if ( minColon == std::string::npos )
+            {
+                errorStream << "Invalid input for parameter 'filter'. Accepted: name:min:max" << std::endl;
+                return false;
+            }
+            DatasetFilter filter;
+            filter.name = filter_strings[i].substr( 0, minColon );
+            filter.minValue = boost::lexical_cast<double>( filter_strings[i].substr( minColon + 1, maxColon - minColon - 1 ) );
+            filter.maxValue = boost::lexical_cast<double>( filter_strings[i].substr( maxColon + 1 ) );
+            options.filters.push_back( filter );
+        }
 
         if ( vm.count( "slice" ) ^ vm.count( "offset" ) )
         {
@@ -163,6 +217,11 @@ bool parseOptions( int argc, char** argv, ProgramOptions &options )
         errorStream << desc << "\n";
         throw std::runtime_error( "Error parsing command line options!" );
     }
+    catch ( const boost::bad_lexical_cast& )
+    {
+        errorStream << desc << "\n";
+        throw std::runtime_error( "Error parsing numbers in 'particle-range' or 'filter'!" );
+    }
 
     return true;
 }
@@ -219,28 +278,33 @@ int main( int argc, char** argv )
     }
 
     ITools *tools = nullptr;
-    switch ( options.fileMode)
-    {
-        case FM_SPLASH: tools = new ToolsSplashParallel( options, mpi_topology, *outStream );
-                        break;
-#if (ENABLE_ADIOS==1)
-        case FM_ADIOS: tools = new ToolsAdiosParallel( options, mpi_topology, *outStream );
-                        break;
-#endif
-    }
+    std::ofstream file;
 
     try
     {
-        std::ofstream file;
         if ( options.toFile )
         {
-            file.open( options.outputFile.c_str( ) );
+            if ( options.binary )
+                file.open( options.outputFile.c_str( ), std::ios::binary );
+            else
+                file.open( options.outputFile.c_str( ) );
             if ( !file.is_open( ) )
                 throw std::runtime_error( "Failed to open output file for writing." );
 
             outStream = &file;
         }
 
+        // the tools keep a reference to the output stream
+        switch ( options.fileMode)
+        {
+            case FM_SPLASH: tools = new ToolsSplashParallel( options, mpi_topology, *outStream );
+                            break;
+#if (ENABLE_ADIOS==1)
+            case FM_ADIOS: tools = new ToolsAdiosParallel( options, mpi_topology, *outStream );
+                            break;
+#endif
+        }
+
         // apply requested command to file
         if ( options.listDatasets )
             tools->listAvailableDatasets( );
@@ -20,9 +20,99 @@
 
 #include <boost/foreach.hpp>
 #include <algorithm>
+#include <thread>
+#include <functional>
+#include <typeinfo>
+#include <cstdio>
 
 #include "tools_splash_parallel.hpp"
 
+namespace
+{
+
+/** get the libSplash data type of a collection type */
+DCDataType getDataType(const CollectionType& colType)
+{
+    if (typeid(colType) == typeid(ColTypeFloat))
+        return DCDT_FLOAT32;
+    if (typeid(colType) == typeid(ColTypeDouble))
+        return DCDT_FLOAT64;
+    if (typeid(colType) == typeid(ColTypeUInt32))
+        return DCDT_UINT32;
+    if (typeid(colType) == typeid(ColTypeUInt64))
+        return DCDT_UINT64;
+    if (typeid(colType) == typeid(ColTypeInt32))
+        return DCDT_INT32;
+    if (typeid(colType) == typeid(ColTypeInt64))
+        return DCDT_INT64;
+    throw DCException("cannot identify datatype");
+}
+
+size_t getTypeSize(DCDataType dataType)
+{
+    switch (dataType)
+    {
+        case DCDT_FLOAT32:
+            return sizeof(float);
+        case DCDT_FLOAT64:
+            return sizeof(double);
+        case DCDT_UINT32:
+            return sizeof(uint32_t);
+        case DCDT_UINT64:
+            return sizeof(uint64_t);
+        case DCDT_INT32:
+            return sizeof(int32_t);
+        case DCDT_INT64:
+            return sizeof(int64_t);
+        default:
+            throw DCException("cannot identify datatype");
+    }
+}
+
+/** get an element as double, the type must be checked with getTypeSize() */
+double getValue(DCDataType dataType, const char* elem)
+{
+    switch (dataType)
+    {
+        case DCDT_FLOAT32:
+            return *((const float*) elem);
+        case DCDT_FLOAT64:
+            return *((const double*) elem);
+        case DCDT_UINT32:
+            return *((const uint32_t*) elem);
+        case DCDT_UINT64:
+            return double(*((const uint64_t*) elem));
+        case DCDT_INT32:
+            return *((const int32_t*) elem);
+        case DCDT_INT64:
+            return double(*((const int64_t*) elem));
+        default:
+            return 0.0;
+    }
+}
+
+/** append an element as text, integers without unit are printed exactly */
+void appendElement(std::string& out, DCDataType dataType, const char* elem, double unit)
+{
+    char text[32];
+    int length;
+
+    if (unit == 1.0 && dataType == DCDT_UINT64)
+        length = snprintf(text, sizeof(text), "%llu", (unsigned long long) *((const uint64_t*) elem));
+    else if (unit == 1.0 && dataType == DCDT_INT64)
+        length = snprintf(text, sizeof(text), "%lld", (long long) *((const int64_t*) elem));
+    else if (unit == 1.0 && dataType == DCDT_UINT32)
+        length = snprintf(text, sizeof(text), "%u", *((const uint32_t*) elem));
+    else if (unit == 1.0 && dataType == DCDT_INT32)
+        length = snprintf(text, sizeof(text), "%d", *((const int32_t*) elem));
+    else
+        length = snprintf(text, sizeof(text), "%.16g", getValue(dataType, elem) * unit);
+
+    out.append(text, length);
+}
+
+} // namespace
+
 ToolsSplashParallel::ToolsSplashParallel(ProgramOptions &options, Dims &mpiTopology, std::ostream &outStream) :
 ITools(options, mpiTopology, outStream),
 dc(MPI_COMM_WORLD, MPI_INFO_NULL, Dimensions(mpiTopology[0], mpiTopology[1], mpiTopology[2]), 100),
@@ -255,6 +345,12 @@ void ToolsSplashParallel::convertToText()
             throw std::runtime_error("Could not identify data class for requested dataset");
     }
 
+    if (m_options.stream)
+    {
+        convertStreaming(ref_data_class);
+        return;
+    }
+
     Domain ref_total_domain;
     ref_total_domain = dc.getGlobalDomain(m_options.step, m_options.data[0].c_str());
 
@@ -349,6 +445,233 @@ void ToolsSplashParallel::convertToText()
     }
 }
 
+StreamDataset ToolsSplashParallel::openStreamDataset(const std::string& name)
+{
+    StreamDataset dataset;
+    dataset.name = name;
+
+    // only the meta data is read, the buffer size is not used
+    Dimensions dstBuffer(1, 1, 1);
+    Dimensions dstOffset(0, 0, 0);
+    Dimensions sizeRead(0, 0, 0);
+    CollectionType* colType = dc.readMeta(m_options.step, name.c_str(),
+            dstBuffer, dstOffset, sizeRead);
+    try
+    {
+        dataset.dataType = getDataType(*colType);
+    } catch (const DCException&)
+    {
+        delete colType;
+        throw;
+    }
+    delete colType;
+
+    dataset.typeSize = getTypeSize(dataset.dataType);
+    dataset.size = sizeRead;
+    dataset.unit = 1.0;
+
+    if (m_options.applyUnits)
+    {
+        try
+        {
+            dc.readAttribute(m_options.step, name.c_str(), "unitSI",
+                    &(dataset.unit), nullptr);
+        } catch (const DCException&)
+        {
+            if (m_options.verbose)
+                errorStream << "no unit for '" << name << "', defaulting to 1.0" << std::endl;
+            dataset.unit = 1.0;
+        }
+    }
+
+    if (m_options.verbose)
+        errorStream << "Streaming dataset '" << name << "' " << dataset.size.toString() <<
+            " with unit '" << dataset.unit << "'" << std::endl;
+
+    return dataset;
+}
+
+void ToolsSplashParallel::convertStreaming(DomainCollector::DomDataClass dataClass)
+{
+    const bool isParticles = dataClass == DomainCollector::PolyType;
+
+    // printed datasets first, datasets only used by filters are appended
+    std::vector<StreamDataset> datasets;
+    for (size_t i = 0; i < m_options.data.size(); ++i)
+        datasets.push_back(openStreamDataset(m_options.data[i]));
+    const size_t numPrinted = datasets.size();
+
+    if (!m_options.filters.empty() && !isParticles)
+        throw std::runtime_error("Filters are only supported for particle data");
+
+    std::vector<size_t> filterDataset(m_options.filters.size());
+    for (size_t f = 0; f < m_options.filters.size(); ++f)
+    {
+        size_t d = 0;
+        while (d < datasets.size() && datasets[d].name != m_options.filters[f].name)
+            ++d;
+        if (d == datasets.size())
+            datasets.push_back(openStreamDataset(m_options.filters[f].name));
+        filterDataset[f] = d;
+    }
+
+    const Dimensions size(datasets[0].size);
+    for (size_t d = 0; d < datasets.size(); ++d)
+        if (datasets[d].size != size)
+            throw std::runtime_error("All requested datasets must have the same size");
+
+    // the output consists of rows with rowLength elements of each printed dataset,
+    // a chunk contains rowsPerChunk rows (particles: one row per particle)
+    Dimensions baseOffset(0, 0, 0);
+    Dimensions baseSize(size);
+    size_t rowAxis = 0;
+    size_t rowLength = 1;
+    uint64_t firstRow = 0;
+    uint64_t numRows = 0;
+
+    if (isParticles)
+    {
+        firstRow = std::min(m_options.particleBegin, uint64_t(size[0]));
+        numRows = std::max(std::min(m_options.particleEnd, uint64_t(size[0])), firstRow) - firstRow;
+    } else
+    {
+        // axes of the slice in memory order and the sliced axis
+        size_t axes[2] = {0, 0};
+        size_t numAxes = 0;
+        size_t sliceAxis = 0;
+        for (size_t i = 0; i < 3; ++i)
+            if (m_options.fieldDims[i] != 0)
+                axes[numAxes++] = i;
+            else
+                sliceAxis = i;
+
+        if (m_options.sliceOffset >= size[sliceAxis])
+            throw DCException("Requested offset outside of domain");
+        baseOffset[sliceAxis] = m_options.sliceOffset;
+        baseSize[sliceAxis] = 1;
+
+        rowAxis = m_options.isReverseSlice ? axes[0] : axes[1];
+        rowLength = size[m_options.isReverseSlice ? axes[1] : axes[0]];
+        numRows = size[rowAxis];
+    }
+
+    // the elements of a row are contiguous in memory except for reverse slices
+    const bool isRowContiguous = isParticles || !m_options.isReverseSlice;
+    const size_t rowsPerChunk = std::max(size_t(1), m_options.chunkSize / rowLength);
+    const size_t numChunks = (numRows + rowsPerChunk - 1) / rowsPerChunk;
+
+    const uint32_t numThreads = m_options.numThreads != 0 ? m_options.numThreads :
+        std::max(1u, std::thread::hardware_concurrency());
+
+    if (m_options.verbose)
+        errorStream << "rows = " << numRows << ", chunks = " << numChunks <<
+            ", threads = " << numThreads << std::endl;
+
+    // read the datasets of a chunk into one of the two buffers
+    auto readChunk = [&](size_t chunk, int bufferIdx)
+    {
+        const size_t rows = std::min(uint64_t(rowsPerChunk), numRows - chunk * rowsPerChunk);
+        Dimensions offset(baseOffset);
+        Dimensions chunkSize(baseSize);
+        offset[rowAxis] = firstRow + chunk * rowsPerChunk;
+        chunkSize[rowAxis] = rows;
+
+        for (size_t d = 0; d < datasets.size(); ++d)
+        {
+            std::vector<char>& buffer = datasets[d].buffer[bufferIdx];
+            buffer.resize(chunkSize.getScalarSize() * datasets[d].typeSize);
+
+            Dimensions sizeRead(0, 0, 0);
+            dc.read(m_options.step, chunkSize, offset, datasets[d].name.c_str(),
+                    sizeRead, &(buffer.front()));
+            if (sizeRead.getScalarSize() != chunkSize.getScalarSize())
+                throw std::runtime_error("Failed to read dataset '" + datasets[d].name + "'");
+        }
+    };
+
+    // format the rows [rowBegin, rowEnd) of a chunk with rows rows
+    auto formatRows = [&](int bufferIdx, size_t rows, size_t rowBegin, size_t rowEnd, std::string& out)
+    {
+        out.clear();
+        for (size_t r = rowBegin; r < rowEnd; ++r)
+        {
+            bool isSelected = true;
+            for (size_t f = 0; f < filterDataset.size() && isSelected; ++f)
+            {
+                const StreamDataset& dataset = datasets[filterDataset[f]];
+                const double value = getValue(dataset.dataType,
+                        &(dataset.buffer[bufferIdx][r * dataset.typeSize])) * dataset.unit;
+                isSelected = value >= m_options.filters[f].minValue &&
+                        value <= m_options.filters[f].maxValue;
+            }
+            if (!isSelected)
+                continue;
+
+            for (size_t i = 0; i < rowLength; ++i)
+            {
+                const size_t index = isRowContiguous ? r * rowLength + i : i * rows + r;
+                for (size_t d = 0; d < numPrinted; ++d)
+                {
+                    const StreamDataset& dataset = datasets[d];
+                    const char* elem = &(dataset.buffer[bufferIdx][index * dataset.typeSize]);
+                    if (m_options.binary)
+                    {
+                        const double value = getValue(dataset.dataType, elem) * dataset.unit;
+                        out.append((const char*) &value, sizeof(double));
+                    } else
+                    {
+                        appendElement(out, dataset.dataType, elem, dataset.unit);
+                        out.append(m_options.delimiter);
+                    }
+                }
+            }
+
+            if (!m_options.binary)
+                out.push_back('\n');
+        }
+    };
+
+    std::vector<std::string> outBuffers(numThreads);
+    if (numChunks != 0)
+        readChunk(0, 0);
+
+    for (size_t chunk = 0; chunk < numChunks; ++chunk)
+    {
+        const int bufferIdx = chunk % 2;
+        const size_t rows = std::min(uint64_t(rowsPerChunk), numRows - chunk * rowsPerChunk);
+
+        std::vector<std::thread> workers;
+        for (uint32_t t = 0; t < numThreads; ++t)
+            workers.push_back(std::thread(formatRows, bufferIdx, rows,
+                    rows * t / numThreads, rows * (t + 1) / numThreads,
+                    std::ref(outBuffers[t])));
+
+        // the next chunk is read while the current one is formatted
+        try
+        {
+            if (chunk + 1 < numChunks)
+                readChunk(chunk + 1, 1 - bufferIdx);
+        } catch (...)
+        {
+            for (size_t t = 0; t < workers.size(); ++t)
+                workers[t].join();
+            throw;
+        }
+
+        for (size_t t = 0; t < workers.size(); ++t)
+            workers[t].join();
+
+        for (size_t t = 0; t < outBuffers.size(); ++t)
+            m_outStream.write(outBuffers[t].data(), outBuffers[t].size());
+
+        if (m_options.verbose)
+            errorStream << "." << std::flush;
+    }
+
+    if (m_options.verbose)
+        errorStream << std::endl;
+}
+
 bool ToolsSplashParallel::DCEntryCompare(DataCollector::DCEntry i, DataCollector::DCEntry j)
 {
     return (i.name < j.name);